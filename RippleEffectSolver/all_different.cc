@@ -0,0 +1,140 @@
+//
+//  all_different.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "all_different.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Kuhn's augmenting path search from `cell`.
+static bool augment(MatchingGraph& graph, int cell) {
+	int n = graph.n;
+	for (int value : graph.valuesForCell[cell]) {
+		if (graph.visited[value - n]) continue;
+		graph.visited[value - n] = true;
+		int other = graph.valueMatch[value - n];
+		if (other == -1 || augment(graph, other)) {
+			graph.cellMatch[cell] = value;
+			graph.valueMatch[value - n] = cell;
+			return true;
+		}
+	}
+	return false;
+}
+
+// Tarjan's algorithm from `node`, recursing into everything it reaches.
+static void strongConnect(MatchingGraph& graph, int node) {
+	int n = graph.n;
+	graph.index[node] = graph.lowLink[node] = graph.nextIndex++;
+	graph.stack.push_back(node);
+	graph.onStack[node] = true;
+
+	auto visit = [&graph, node](int next) {
+		if (graph.index[next] == -1) {
+			strongConnect(graph, next);
+			graph.lowLink[node] =
+				std::min(graph.lowLink[node], graph.lowLink[next]);
+		} else if (graph.onStack[next]) {
+			graph.lowLink[node] =
+				std::min(graph.lowLink[node], graph.index[next]);
+		}
+	};
+	if (node < n) {
+		for (int value : graph.valuesForCell[node]) {
+			if (value != graph.cellMatch[node]) visit(value);
+		}
+	} else {
+		visit(graph.valueMatch[node - n]);
+	}
+
+	if (graph.lowLink[node] == graph.index[node]) {
+		int member;
+		do {
+			member = graph.stack.back();
+			graph.stack.pop_back();
+			graph.onStack[member] = false;
+			graph.component[member] = graph.components;
+		} while (member != node);
+		graph.components++;
+	}
+}
+
+void MatchingGraph::reserve(int cells) {
+	valueBits.reserve(cells);
+	if (valuesForCell.size() < cells) valuesForCell.resize(cells);
+	for (auto& values : valuesForCell) {
+		values.reserve(cells);
+	}
+	cellMatch.reserve(cells);
+	valueMatch.reserve(cells);
+	visited.reserve(cells);
+	index.reserve(2 * cells);
+	lowLink.reserve(2 * cells);
+	component.reserve(2 * cells);
+	onStack.reserve(2 * cells);
+	stack.reserve(2 * cells);
+}
+
+bool pruneAllDifferent(std::vector<uint64_t>& domains, uint64_t values,
+					   MatchingGraph* scratch) {
+	MatchingGraph local;
+	MatchingGraph& graph = scratch ? *scratch : local;
+	int n = graph.n = (int)domains.size();
+	graph.valueBits.clear();
+	for (int bit = 0; bit < 64; bit++) {
+		if (values >> bit & 1) graph.valueBits.push_back(bit);
+	}
+	if (graph.valueBits.size() != n) {
+		return false;
+	}
+
+	if (graph.valuesForCell.size() < n) graph.valuesForCell.resize(n);
+	for (int cell = 0; cell < n; cell++) {
+		std::vector<int>& valuesForCell = graph.valuesForCell[cell];
+		valuesForCell.clear();
+		for (int i = 0; i < n; i++) {
+			if (domains[cell] >> graph.valueBits[i] & 1) {
+				valuesForCell.push_back(n + i);
+			}
+		}
+	}
+	graph.cellMatch.assign(n, -1);
+	graph.valueMatch.assign(n, -1);
+	for (int cell = 0; cell < n; cell++) {
+		graph.visited.assign(n, false);
+		if (!augment(graph, cell)) {
+			// Some set of cells has fewer values between them than cells.
+			return false;
+		}
+	}
+
+	graph.index.assign(2 * n, -1);
+	graph.lowLink.assign(2 * n, 0);
+	graph.component.assign(2 * n, -1);
+	graph.onStack.assign(2 * n, false);
+	graph.stack.clear();
+	graph.nextIndex = graph.components = 0;
+	for (int node = 0; node < 2 * n; node++) {
+		if (graph.index[node] == -1) strongConnect(graph, node);
+	}
+
+	// Every value is matched, so an unmatched edge can only swap into a
+	// perfect matching around a cycle, i.e. within one component.
+	for (int cell = 0; cell < n; cell++) {
+		uint64_t kept = 0;
+		for (int value : graph.valuesForCell[cell]) {
+			if (value == graph.cellMatch[cell] ||
+				graph.component[value] == graph.component[cell]) {
+				kept |= 1ULL << graph.valueBits[value - n];
+			}
+		}
+		domains[cell] = kept;
+	}
+	return true;
+}
@@ -0,0 +1,60 @@
+//
+//  all_different.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef all_different_h
+#define all_different_h
+
+#include <cstdint>
+#include <vector>
+
+// Domains are bitmasks where bit v set means value v is still possible.
+
+// The bipartite graph between cells and values, as the algorithm sees it, and
+// its working space. Passing the same one to every call means calling over and
+// over doesn't allocate each time, once it has grown to the most cells any
+// call has.
+struct MatchingGraph {
+	// Cells are numbered 0 to n - 1, and values n to 2n - 1 in ascending
+	// order. `valueBits` maps value nodes (indexed from 0) back to bits.
+	int n = 0;
+	std::vector<int> valueBits;
+	// For each cell, the value nodes in its domain. Only the first n are used.
+	std::vector<std::vector<int>> valuesForCell;
+	// The value node matched to each cell, and the cell matched to each value
+	// node (indexed from 0), or -1.
+	std::vector<int> cellMatch, valueMatch;
+	// Value nodes (indexed from 0) seen by the current augmenting path search.
+	std::vector<bool> visited;
+
+	// Tarjan's strongly connected components over the matching's residual
+	// graph: cell -> value along unmatched edges, value -> cell along matched
+	// ones.
+	std::vector<int> index, lowLink, component;
+	std::vector<bool> onStack;
+	std::vector<int> stack;
+	int nextIndex = 0, components = 0;
+
+	// Grows everything to fit `cells` cells up front.
+	void reserve(int cells);
+};
+
+// Prunes the domains of a set of cells that must take every value in `values`
+// exactly once between them (so there must be exactly as many cells as values),
+// like the empty cells of a room and the values it's missing. Afterwards, a
+// value is left in a cell's domain only if some assignment of every value to a
+// distinct cell puts it there; this catches hidden pairs, triples and so on of
+// any size. Returns false if no such assignment exists at all.
+//
+// Works by finding one perfect matching between cells and values, then keeping
+// only the edges that are either in it or lie on an alternating cycle, which
+// are exactly the edges in some perfect matching (Régin's algorithm). If
+// `scratch` is not null, it's worked in rather than fresh memory.
+bool pruneAllDifferent(std::vector<uint64_t>& domains, uint64_t values,
+					   MatchingGraph* scratch = nullptr);
+
+#endif /* all_different_h */
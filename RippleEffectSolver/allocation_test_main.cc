@@ -0,0 +1,148 @@
+//
+//  allocation_test_main.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ripple_effect.h"
+#include "room_tables.h"
+#include "solve_puzzle.h"
+#include "solver_options.h"
+#include "transposition_table.h"
+#include "typedefs.h"
+
+// Checks that a Solver, once it has solved a board, solves it again without
+// allocating: every call to operator new is counted, and counting or listing
+// the solutions with a warm Solver must not make any. `make check` runs it.
+// Exits with 1 if anything allocated.
+
+// Puzzle settings. The puzzles to solve, read from files in the current
+// directory in the same format the solver reads from stdin.
+const std::vector<std::string> puzzleFiles = {
+	"Puzzle4.txt", "MultipleSolutions1.txt", "MultipleSolutions2.txt",
+	"GeneratedPuzzle3.txt"};
+
+// Repetition settings. Each search runs once to warm the Solver up, then this
+// many more times with allocations counted.
+int repetitions = 3;
+
+// Table settings. Room tables are built for rooms of up to roomTableMaxCells
+// cells, and the transposition table holds up to transpositionTableEntries
+// entries.
+int roomTableMaxCells = 5;
+size_t transpositionTableEntries = 1 << 16;
+
+static std::atomic<long long> allocations(0);
+
+void* operator new(size_t size) {
+	allocations++;
+	void* memory = std::malloc(size ? size : 1);
+	if (!memory) throw std::bad_alloc();
+	return memory;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete[](void* memory) noexcept { std::free(memory); }
+
+// Every search feature that runs at each node, one configuration each. Room
+// tables and transposition tables are the ones given.
+static std::vector<std::pair<std::string, SolverOptions>>
+searchConfigurations(const RoomTables* roomTables,
+					 TranspositionTable* transpositionTable) {
+	std::vector<std::pair<std::string, SolverOptions>> configurations;
+	configurations.push_back({"plain", SolverOptions()});
+	SolverOptions options;
+	options.lineRules = true;
+	configurations.push_back({"line rules", options});
+	options = SolverOptions();
+	options.roomMatching = true;
+	configurations.push_back({"room matching", options});
+	options = SolverOptions();
+	options.probeBudget = 1000;
+	configurations.push_back({"probing", options});
+	options = SolverOptions();
+	options.lineRules = true;
+	options.roomMatching = true;
+	options.valueOrder = ValueOrder::kLeastConstraining;
+	configurations.push_back({"least constraining", options});
+	options = SolverOptions();
+	options.valueOrder = ValueOrder::kSmallestFootprint;
+	configurations.push_back({"smallest footprint", options});
+	options = SolverOptions();
+	options.roomTables = roomTables;
+	configurations.push_back({"room tables", options});
+	options.roomBranching = true;
+	configurations.push_back({"room branching", options});
+	options = SolverOptions();
+	options.transpositionTable = transpositionTable;
+	configurations.push_back({"transposition table", options});
+	return configurations;
+}
+
+int main(void) {
+	bool passed = true;
+	for (const std::string& file : puzzleFiles) {
+		std::ifstream input(file);
+		Board cellValues, roomIds;
+		std::string error;
+		if (!parsePuzzle(input, &cellValues, &roomIds, &error)) {
+			std::cerr << file << ": " << error << std::endl;
+			return 1;
+		}
+		Solver solver(roomIds);
+		RoomTables roomTables(solver.roomMap(), roomTableMaxCells);
+		size_t largestRoom = 0;
+		for (const auto& roomAndCells : solver.roomMap()) {
+			largestRoom = std::max(largestRoom, roomAndCells.second.size());
+		}
+		TranspositionTable transpositionTable(
+			(int)roomIds.size(), (int)roomIds[0].size(), (int)largestRoom,
+			transpositionTableEntries);
+		long long visited = 0;
+		std::function<bool(const Board&)> visit = [&visited](const Board&) {
+			visited++;
+			return true;
+		};
+		for (const auto& nameAndOptions :
+			 searchConfigurations(&roomTables, &transpositionTable)) {
+			const SolverOptions& options = nameAndOptions.second;
+			solver.countSolutions(cellValues, 0, 0, options);
+			solver.enumerateSolutions(cellValues, 0, visit, options);
+
+			long long before = allocations;
+			for (int i = 0; i < repetitions; i++) {
+				solver.countSolutions(cellValues, 0, 0, options);
+			}
+			long long counting = allocations - before;
+			before = allocations;
+			for (int i = 0; i < repetitions; i++) {
+				solver.enumerateSolutions(cellValues, 0, visit, options);
+			}
+			long long listing = allocations - before;
+
+			bool ok = counting == 0 && listing == 0;
+			passed = passed && ok;
+			std::cout << (ok ? "ok   " : "FAIL ") << file << ", "
+					  << nameAndOptions.first << ": " << counting
+					  << " allocations counting, " << listing
+					  << " listing." << std::endl;
+		}
+	}
+	return passed ? 0 : 1;
+}
@@ -8,17 +8,49 @@
 
 #include "augment_puzzle.h"
 
+#include <cmath>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <numeric>
 #include <utility>
 
+#include "minimize_clues.h"
 #include "print_board.h"
+#include "sample_solutions.h"
+#include "solution_diagram.h"
 #include "solve_puzzle.h"
+#include "solver_options.h"
 #include "typedefs.h"
 #include "validity_checks.h"
 
+// Prints a proportion of solutions estimated by sampling as a percentage,
+// along with its confidence interval.
+static void printProportion(const ProportionEstimate& proportion) {
+	std::cout << std::fixed << std::setprecision(1) << " (estimated "
+			  << proportion.estimate * 100 << "%, between "
+			  << proportion.lower * 100 << "% and " << proportion.upper * 100
+			  << "%)" << std::defaultfloat << std::setprecision(6);
+}
+
+// Whether the only difference from `before` to `after` is one clue added to a
+// cell that was empty, in which case `cell` is set to it.
+static bool addedOneClue(const Board& before, const Board& after, Cell* cell) {
+	int added = 0;
+	for (int r = 0; r < before.size(); r++) {
+		for (int c = 0; c < before[r].size(); c++) {
+			if (before[r][c] == after[r][c]) continue;
+			if (before[r][c] || ++added > 1) return false;
+			*cell = {r, c};
+		}
+	}
+	return added == 1;
+}
+
 int augmentPuzzle(Board& cellValues, const Board& roomIds, int verbosity,
-				  int solvingVerbosity) {
+				  int solvingVerbosity, const SamplingOptions* sampling,
+				  bool useSolutionDiagram, const MinimizeOptions* minimizing) {
 	std::cout << "Initial board state:" << std::endl;
 	printBoard(cellValues, roomIds);
 
@@ -47,6 +79,16 @@ int augmentPuzzle(Board& cellValues, const Board& roomIds, int verbosity,
 	// inferred cells; the canonical board.
 	Board originalBoard = cellValues;
 
+	// Every board below has the same rooms, so one solver serves them all and
+	// reuses its memory from one board to the next.
+	Solver solver(roomIds);
+
+	// The last solution diagram compiled, and the input board it's for. Adding
+	// a clue to that board only needs the diagram restricted to it, rather
+	// than every solution compiled again.
+	std::unique_ptr<SolutionDiagram> diagram;
+	Board diagramBoard;
+
 	do {
 		// Wipe out any cells that we filled in without the user specifying a
 		// value. This prevents issues with things like the user attempting to
@@ -61,13 +103,75 @@ int augmentPuzzle(Board& cellValues, const Board& roomIds, int verbosity,
 		std::cout << "Currently known cell values:" << std::endl;
 		printBoard(cellValues, roomIds);
 
-		std::cout << "Computing all solutions to the current board..."
-				  << std::endl;
 		bool solved;
 		std::set<Board> boards;
-		std::tie(solved, boards) =
-			findAllSolutions(cellValues, roomIds, roomMap, cellsCompletedInRoom,
-							 solvingVerbosity);
+		// Only filled in when sampling.
+		SolutionEstimate estimate;
+		Cell addedClue;
+		if (sampling) {
+			std::cout << "Checking the current board for a unique solution..."
+					  << std::endl;
+			int count = solver.countSolutions(cellValues, solvingVerbosity, 2);
+			solved = count > 0;
+			if (count == 1) {
+				boards.insert(
+					solver.findSingleSolution(cellValues, solvingVerbosity)
+						.second);
+			} else if (count > 1) {
+				std::cout << "Sampling solutions to the current board..."
+						  << std::endl;
+				estimate = estimateValueFrequencies(
+					cellValues, roomIds, roomMap, cellsCompletedInRoom,
+					*sampling, solvingVerbosity);
+				if (estimate.samples == 0) {
+					std::cerr << "Sampling failed to find any solutions. Try "
+								 "a larger budget."
+							  << std::endl;
+					return 1;
+				}
+			}
+		} else if (useSolutionDiagram) {
+			if (diagram && diagramBoard == originalBoard) {
+				// Back to the board the diagram is for, after an undo.
+				solved = diagram->solutionCount() > 0;
+			} else if (diagram && addedOneClue(diagramBoard, originalBoard,
+											   &addedClue)) {
+				std::cout << "Restricting the compiled solutions to the new "
+							 "clue..."
+						  << std::endl;
+				SolutionDiagram restricted = diagram->restrict(
+					addedClue,
+					originalBoard[addedClue.first][addedClue.second]);
+				solved = restricted.solutionCount() > 0;
+				// Keep the old diagram for the undo that follows otherwise.
+				if (solved) {
+					diagram.reset(new SolutionDiagram(std::move(restricted)));
+					diagramBoard = originalBoard;
+				}
+			} else {
+				std::cout << "Compiling all solutions to the current board..."
+						  << std::endl;
+				std::unique_ptr<SolutionDiagram> compiled(new SolutionDiagram(
+					cellValues, roomIds, roomMap, cellsCompletedInRoom,
+					solvingVerbosity));
+				solved = compiled->solutionCount() > 0;
+				if (solved || !diagram) {
+					diagram.swap(compiled);
+					diagramBoard = originalBoard;
+				}
+			}
+			if (solved && diagram->solutionCount() == 1) {
+				diagram->forEachSolution([&boards](const Board& board) {
+					boards.insert(board);
+					return false;
+				});
+			}
+		} else {
+			std::cout << "Computing all solutions to the current board..."
+					  << std::endl;
+			std::tie(solved, boards) =
+				solver.findAllSolutions(cellValues, solvingVerbosity);
+		}
 
 		if (!solved) {
 			// We've run into a dead end. Undo if we can, otherwise fail.
@@ -101,6 +205,47 @@ int augmentPuzzle(Board& cellValues, const Board& roomIds, int verbosity,
 			std::cout << "Raw initial board:" << std::endl;
 			uglyPrintBoard(originalBoard, roomIds);
 #endif /* SIMPLE_PRINT_BOARD */
+			if (minimizing) {
+				std::cout << "Removing clues the solution doesn't need..."
+						  << std::endl;
+				MinimizeResult minimal =
+					minimizeClues(originalBoard, roomIds, *minimizing);
+				if (!minimal.unique) {
+					std::cerr << "Checking the initial board ran out of nodes. "
+								 "Try a larger budget."
+							  << std::endl;
+					return 1;
+				}
+				std::cout << "Removed "
+						  << minimal.cluesBefore - minimal.cluesAfter << " of "
+						  << minimal.cluesBefore << " clues in "
+						  << minimal.seconds << " seconds, with "
+						  << minimal.checks << " checks ("
+						  << minimal.propagationChecks
+						  << " settled by filling in known cells, "
+						  << minimal.repeatedChecks << " repeated) in "
+						  << minimal.batches << " batches on up to "
+						  << minimal.threads << " threads." << std::endl;
+				if (minimal.undecided > 0) {
+					std::cout << minimal.undecided << " of the clues left "
+							  << (minimal.undecided == 1 ? "was" : "were")
+							  << " only kept because checking ran out of "
+								 "nodes, so the board may not be minimal."
+							  << std::endl;
+				}
+				switch (verbosity) {
+					case 2:
+						printSolverStats(minimal.stats);
+					default:
+						break;
+				}
+				std::cout << "Minimal board:" << std::endl;
+				printBoard(minimal.cellValues, roomIds);
+#ifndef SIMPLE_PRINT_BOARD
+				std::cout << "Raw minimal board:" << std::endl;
+				uglyPrintBoard(minimal.cellValues, roomIds);
+#endif /* SIMPLE_PRINT_BOARD */
+			}
 			return 0;
 		} else {
 			// This is the longest case by far. We have multiple solutions.
@@ -115,6 +260,15 @@ int augmentPuzzle(Board& cellValues, const Board& roomIds, int verbosity,
 								  << std::endl;
 						printBoard(board, roomIds);
 					}
+					if (diagram) {
+						diagram->forEachSolution(
+							[&solution, &roomIds](const Board& board) {
+								std::cout << "Solution " << solution++ << ":"
+										  << std::endl;
+								printBoard(board, roomIds);
+								return true;
+							});
+					}
 				}
 				default:
 					break;
@@ -126,10 +280,17 @@ int augmentPuzzle(Board& cellValues, const Board& roomIds, int verbosity,
 			int beforeAggregation = countKnownCells(cellValues);
 			std::cout << "Currently known cell values:" << std::endl;
 			printBoard(cellValues, roomIds);
-			std::cout << "Aggregating cells across all solutions to see if any "
-						 "other cells are known..."
-					  << std::endl;
-			cellValues = aggregateBoards(boards);
+			if (sampling) {
+				std::cout << "Skipping aggregation since solutions were only "
+							 "sampled."
+						  << std::endl;
+			} else {
+				std::cout << "Aggregating cells across all solutions to see if "
+							 "any other cells are known..."
+						  << std::endl;
+				cellValues =
+					diagram ? diagram->consensus() : aggregateBoards(boards);
+			}
 			int afterAggregation = countKnownCells(cellValues);
 			int aggregationDifference = afterAggregation - beforeAggregation;
 
@@ -159,11 +320,55 @@ int augmentPuzzle(Board& cellValues, const Board& roomIds, int verbosity,
 			std::cout << "There " << (unknownCells == 1 ? "is" : "are")
 					  << " currently " << unknownCells << " unknown cell"
 					  << (unknownCells == 1 ? "" : "s") << "." << std::endl;
-			std::cout << "The puzzle currently has " << boards.size()
-					  << " solutions." << std::endl;
-
-			const auto& valueFrequencyForCell =
-				generateValueFrequencies(boards);
+			// When sampling, this and the frequencies below are estimates
+			// scaled up from the samples' weighted proportions.
+			size_t solutionCount = boards.size();
+			std::vector<std::vector<std::map<int, int>>> valueFrequencyForCell;
+			if (sampling) {
+				solutionCount = (size_t)std::llround(estimate.solutionCount);
+				std::cout << "The puzzle currently has an estimated "
+						  << solutionCount << " solutions (between "
+						  << std::llround(estimate.solutionCountLower)
+						  << " and "
+						  << std::llround(estimate.solutionCountUpper)
+						  << ", from " << estimate.samples << " of "
+						  << estimate.attempts << " random walks)."
+						  << std::endl;
+				for (const auto& estimateRow : estimate.valueFrequencies) {
+					valueFrequencyForCell.emplace_back(estimateRow.size());
+					auto& frequencyRow = valueFrequencyForCell.back();
+					for (int col = 0; col < estimateRow.size(); col++) {
+						for (const auto& valueAndEstimate : estimateRow[col]) {
+							// Never round a value that was seen down to 0.
+							double scaled = valueAndEstimate.second.estimate *
+											solutionCount;
+							frequencyRow[col][valueAndEstimate.first] =
+								(int)std::max(1LL, std::llround(scaled));
+						}
+					}
+				}
+			} else if (diagram) {
+				solutionCount = (size_t)diagram->solutionCount();
+				std::cout << "The puzzle currently has " << solutionCount
+						  << " solutions (compiled into " << diagram->nodeCount()
+						  << " diagram nodes)." << std::endl;
+				for (const auto& frequencyRow : diagram->valueFrequencies()) {
+					valueFrequencyForCell.emplace_back(frequencyRow.size());
+					auto& narrowedRow = valueFrequencyForCell.back();
+					for (int col = 0; col < frequencyRow.size(); col++) {
+						for (const auto& valueAndFrequency : frequencyRow[col]) {
+							narrowedRow[col][valueAndFrequency.first] =
+								(int)std::min<unsigned long long>(
+									valueAndFrequency.second,
+									std::numeric_limits<int>::max());
+						}
+					}
+				}
+			} else {
+				std::cout << "The puzzle currently has " << boards.size()
+						  << " solutions." << std::endl;
+				valueFrequencyForCell = generateValueFrequencies(boards);
+			}
 
 		// Now ask for a cell to overwrite.
 		input:
@@ -194,8 +399,13 @@ int augmentPuzzle(Board& cellValues, const Board& roomIds, int verbosity,
 							std::cout
 								<< '\t' << "Solutions with "
 								<< valueAndFrequency.first
-								<< " in this cell: " << valueAndFrequency.second
-								<< std::endl;
+								<< " in this cell: " << valueAndFrequency.second;
+							if (sampling) {
+								printProportion(
+									estimate.valueFrequencies[row][col].at(
+										valueAndFrequency.first));
+							}
+							std::cout << std::endl;
 						}
 					}
 				}
@@ -230,7 +440,27 @@ int augmentPuzzle(Board& cellValues, const Board& roomIds, int verbosity,
 								suggestedValues.push_back(
 									valueAndFrequency.first);
 							}
-							if (valueAndFrequency.second == 1) {
+							if (sampling) {
+								// Sampled frequencies are only estimates, so
+								// no value is promised to eliminate every
+								// other solution.
+								const auto& proportion =
+									estimate.valueFrequencies[row][col].at(
+										valueAndFrequency.first);
+								if (proportion.estimate <= 0.1) {
+									std::cout
+										<< "Cell (" << row + 1 << ", "
+										<< col + 1
+										<< ") can be filled with a value of "
+										<< valueAndFrequency.first
+										<< " to leave an estimated "
+										<< valueAndFrequency.second
+										<< " remaining solutions";
+									printProportion(proportion);
+									std::cout << "." << std::endl;
+									suggested = true;
+								}
+							} else if (valueAndFrequency.second == 1) {
 								std::cout
 									<< "Cell (" << row + 1 << ", " << col + 1
 									<< ") can be filled with a value of "
@@ -239,13 +469,13 @@ int augmentPuzzle(Board& cellValues, const Board& roomIds, int verbosity,
 									<< std::endl;
 								suggested = true;
 							} else if (valueAndFrequency.second <=
-									   boards.size() / 10) {
+									   solutionCount / 10) {
 								std::cout
 									<< "Cell (" << row + 1 << ", " << col + 1
 									<< ") can be filled with a value of "
 									<< valueAndFrequency.first
 									<< " to eliminate "
-									<< boards.size() - valueAndFrequency.second
+									<< solutionCount - valueAndFrequency.second
 									<< " other solutions, leaving "
 									<< valueAndFrequency.second
 									<< " remaining solutions." << std::endl;
@@ -266,8 +496,15 @@ int augmentPuzzle(Board& cellValues, const Board& roomIds, int verbosity,
 								  << suggestedValues[i]
 								  << " to eliminate the largest number of "
 									 "other solutions, leaving "
-								  << minFrequency << " remaining solutions."
-								  << std::endl;
+								  << (sampling ? "an estimated " : "")
+								  << minFrequency << " remaining solutions";
+						if (sampling) {
+							printProportion(
+								estimate.valueFrequencies[suggestedRows[i]]
+														 [suggestedCols[i]]
+									.at(suggestedValues[i]));
+						}
+						std::cout << "." << std::endl;
 					}
 				}
 				goto input;
@@ -9,6 +9,8 @@
 #ifndef augment_puzzle_h
 #define augment_puzzle_h
 
+#include "minimize_clues.h"
+#include "sample_solutions.h"
 #include "typedefs.h"
 
 // Main interactive routine. General flow:
@@ -16,7 +18,19 @@
 //   - If no solutions, undo the previous action if possible, otherwise fail.
 //   - If one solution, we're done and we've generated a puzzle.
 //   - If multiple solutions, ask the user for a new cell to fill in.
+// If `sampling` is not null, solutions are only counted up to 2 and value
+// frequencies are estimated from random samples instead, which keeps memory
+// use flat on boards with far too many solutions to enumerate. Aggregation is
+// skipped in that mode, since samples can't prove that a cell is known.
+// Otherwise, if `useSolutionDiagram` is true, solutions are compiled into a
+// SolutionDiagram instead of a set, which gives the same (exact) answers with
+// far less memory on boards with many solutions. If `minimizing` is not null,
+// once the solution is unique every clue it doesn't need is taken away too
+// (see minimize_clues.h).
 int augmentPuzzle(Board& cellValues, const Board& roomIds, int verbosity,
-				  int solvingVerbosity);
+				  int solvingVerbosity,
+				  const SamplingOptions* sampling = nullptr,
+				  bool useSolutionDiagram = false,
+				  const MinimizeOptions* minimizing = nullptr);
 
 #endif /* augment_puzzle_h */
@@ -0,0 +1,125 @@
+//
+//  benchmark_main.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "generate_puzzle.h"
+#include "ripple_effect.h"
+#include "typedefs.h"
+
+// A fixed workload for comparing builds, which `make benchmark` runs against
+// every build variant and `make pgo` trains on. Each puzzle is solved for one
+// solution, counted, and has every solution listed, all through solve().
+
+// Puzzle settings. The puzzles to solve, read from files in the current
+// directory in the same format the solver reads from stdin.
+const std::vector<std::string> puzzleFiles = {
+	"Puzzle1.txt",			  "Puzzle2.txt",
+	"Puzzle3.txt",			  "Puzzle4.txt",
+	"MultipleSolutions1.txt", "MultipleSolutions2.txt",
+	"GeneratedPuzzle1.txt",	  "GeneratedPuzzle2.txt",
+	"GeneratedPuzzle3.txt"};
+
+// Generation settings. Empty boards of generatedWidth by generatedHeight cells
+// are generated from seeds 1 to generatedBoards and solved too, as the creator
+// does. Plenty of generated layouts are unsolvable, and on bigger boards
+// proving so can take a long time, so each search on one gives up after
+// generatedNodeBudget search nodes.
+int generatedBoards = 40;
+int generatedWidth = 5;
+int generatedHeight = 5;
+long long generatedNodeBudget = 200000;
+
+// Repetition settings. The whole workload runs this many times and the fastest
+// run is reported, which irons out noise from the rest of the machine.
+int repetitions = 3;
+
+// Verbosity settings. 0 = print only the total time, 1 = also print the time
+// spent on each puzzle in the fastest run.
+int verbosity = 1;
+
+struct Puzzle {
+	std::string name;
+	Board cellValues, roomIds;
+	long long nodeBudget;
+};
+
+// Seconds taken to solve `puzzle` every way the workload does.
+static double runPuzzle(const Puzzle& puzzle) {
+	SolveRequest request;
+	request.cellValues = puzzle.cellValues;
+	request.roomIds = puzzle.roomIds;
+	request.options.nodeBudget = puzzle.nodeBudget;
+	auto start = std::chrono::steady_clock::now();
+	for (SolveMode mode :
+		 {SolveMode::kSingle, SolveMode::kCount, SolveMode::kAll}) {
+		request.mode = mode;
+		solve(request);
+	}
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+										 start)
+		.count();
+}
+
+int main(void) {
+	std::vector<Puzzle> puzzles;
+	for (const std::string& file : puzzleFiles) {
+		std::ifstream input(file);
+		Puzzle puzzle = {file, {}, {}, 0};
+		std::string error;
+		if (!input ||
+			!parsePuzzle(input, &puzzle.cellValues, &puzzle.roomIds, &error)) {
+			std::cerr << "Couldn't read " << file << ". " << error
+					  << " Terminating." << std::endl;
+			return 1;
+		}
+		puzzles.push_back(puzzle);
+	}
+	for (int seed = 1; seed <= generatedBoards; seed++) {
+		Puzzle puzzle = {"Generated with seed " + std::to_string(seed),
+						 {},
+						 {},
+						 generatedNodeBudget};
+		std::tie(puzzle.cellValues, puzzle.roomIds) =
+			generatePuzzle(generatedWidth, generatedHeight, seed, 0, 0);
+		puzzles.push_back(puzzle);
+	}
+
+	std::vector<double> best(puzzles.size());
+	double bestTotal = 0;
+	for (int run = 0; run < repetitions; run++) {
+		std::vector<double> times;
+		double total = 0;
+		for (const Puzzle& puzzle : puzzles) {
+			times.push_back(runPuzzle(puzzle));
+			total += times.back();
+		}
+		if (run == 0 || total < bestTotal) {
+			best = times;
+			bestTotal = total;
+		}
+	}
+
+	switch (verbosity) {
+		case 1:
+			for (int i = 0; i < puzzles.size(); i++) {
+				std::printf("%-24s %9.4f s\n", puzzles[i].name.c_str(),
+							best[i]);
+			}
+		default:
+			break;
+	}
+	std::printf("Total: %.4f s\n", bestTotal);
+	return 0;
+}
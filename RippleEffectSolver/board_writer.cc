@@ -0,0 +1,112 @@
+//
+//  board_writer.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "board_writer.h"
+
+#include <ostream>
+#include <string>
+
+#include "print_board.h"
+#include "typedefs.h"
+
+// Appends `value` in decimal without going through a temporary string.
+static void appendNumber(long long value, std::string* out) {
+	char digits[24];
+	int length = 0;
+	unsigned long long magnitude =
+		value < 0 ? 0ULL - (unsigned long long)value : value;
+	do {
+		digits[length++] = '0' + magnitude % 10;
+		magnitude /= 10;
+	} while (magnitude);
+	if (value < 0) {
+		*out += '-';
+	}
+	while (length) {
+		*out += digits[--length];
+	}
+}
+
+// Appends `board` one row per line, then a blank line.
+static void appendRows(const Board& board, std::string* out) {
+	for (const auto& row : board) {
+		for (int c = 0; c < row.size(); c++) {
+			if (c) {
+				*out += ' ';
+			}
+			appendNumber(row[c], out);
+		}
+		*out += '\n';
+	}
+	*out += '\n';
+}
+
+BoardWriter::BoardWriter(std::ostream& out, OutputFormat format,
+						 const Board& roomIds)
+	: out(out), format(format), roomIds(roomIds) {
+	buffer.reserve(kFlushBytes * 2);
+}
+
+BoardWriter::~BoardWriter() { flush(); }
+
+void BoardWriter::write(const Board& board) {
+	written++;
+	switch (format) {
+		case OutputFormat::kPretty:
+			buffer += "Solution ";
+			appendNumber(written, &buffer);
+			buffer += ":\n";
+			renderBoard(board, roomIds, &buffer);
+			break;
+		case OutputFormat::kCompact:
+			for (int r = 0; r < board.size(); r++) {
+				for (int c = 0; c < board[r].size(); c++) {
+					if (r || c) {
+						buffer += ' ';
+					}
+					appendNumber(board[r][c], &buffer);
+				}
+			}
+			buffer += '\n';
+			break;
+		case OutputFormat::kJsonLines:
+			buffer += "{\"solution\":";
+			appendNumber(written, &buffer);
+			buffer += ",\"cells\":[";
+			for (int r = 0; r < board.size(); r++) {
+				buffer += r ? ",[" : "[";
+				for (int c = 0; c < board[r].size(); c++) {
+					if (c) {
+						buffer += ',';
+					}
+					appendNumber(board[r][c], &buffer);
+				}
+				buffer += ']';
+			}
+			buffer += "]}\n";
+			break;
+	}
+	if (buffer.size() >= kFlushBytes) {
+		out.write(buffer.data(), buffer.size());
+		buffer.clear();
+	}
+}
+
+void BoardWriter::flush() {
+	if (!buffer.empty()) {
+		out.write(buffer.data(), buffer.size());
+		buffer.clear();
+	}
+	out.flush();
+}
+
+void appendPuzzle(const Board& cellValues, const Board& roomIds,
+				  std::string* out) {
+	appendRows(cellValues, out);
+	appendRows(roomIds, out);
+}
@@ -0,0 +1,63 @@
+//
+//  board_writer.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef board_writer_h
+#define board_writer_h
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+#include "typedefs.h"
+
+// How BoardWriter lays out each board.
+enum class OutputFormat {
+	// "Solution <n>:" followed by printBoard's drawing of the board.
+	kPretty,
+	// One line per board: every cell's value, row by row, separated by spaces.
+	kCompact,
+	// One JSON object per line: {"solution":<n>,"cells":[[...],...]}.
+	kJsonLines,
+};
+
+// Writes a stream of solved boards, such as every solution to a puzzle. Boards
+// are rendered into a buffer that is reused from one to the next and handed to
+// the stream in large blocks, rather than a character at a time with a flush
+// after every row.
+class BoardWriter {
+   public:
+	// Writes boards with rooms `roomIds` to `out` in `format`. Both must
+	// outlive the writer.
+	BoardWriter(std::ostream& out, OutputFormat format, const Board& roomIds);
+	// Flushes.
+	~BoardWriter();
+
+	// Writes `board` as the next solution, numbered from 1.
+	void write(const Board& board);
+
+	// Writes out everything buffered so far and flushes the stream.
+	void flush();
+
+   private:
+	// Buffered bytes past which write() hands the buffer to the stream.
+	static const size_t kFlushBytes = 1 << 16;
+
+	std::ostream& out;
+	OutputFormat format;
+	const Board& roomIds;
+	long long written = 0;
+	std::string buffer;
+};
+
+// Appends the puzzle with clues `cellValues` and rooms `roomIds` to `out` in
+// the format the solver reads from stdin (see parsePuzzle), followed by a blank
+// line, so that puzzles appended one after another make an archive.
+void appendPuzzle(const Board& cellValues, const Board& roomIds,
+				  std::string* out);
+
+#endif /* board_writer_h */
@@ -0,0 +1,185 @@
+//
+//  canonical_form.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "canonical_form.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "typedefs.h"
+
+// The finalizer from SplitMix64, which spreads every input bit over the
+// whole output.
+static uint64_t mix(uint64_t value) {
+	value ^= value >> 30;
+	value *= 0xbf58476d1ce4e5b9ULL;
+	value ^= value >> 27;
+	value *= 0x94d049bb133111ebULL;
+	value ^= value >> 31;
+	return value;
+}
+
+// Builds a Fingerprint a word at a time, in two independently seeded lanes.
+class FingerprintBuilder {
+   public:
+	void add(uint64_t word) {
+		high = mix(high ^ word) * 0x9e3779b97f4a7c15ULL;
+		low = mix(low + word) ^ (low >> 29);
+		words++;
+	}
+
+	Fingerprint finish() const {
+		Fingerprint fingerprint;
+		fingerprint.high = mix(high ^ words);
+		fingerprint.low = mix(low + words * 0xd6e8feb86659fd93ULL);
+		return fingerprint;
+	}
+
+   private:
+	uint64_t high = 0x243f6a8885a308d3ULL;
+	uint64_t low = 0x13198a2e03707344ULL;
+	uint64_t words = 0;
+};
+
+Board relabelRooms(const Board& roomIds) {
+	std::map<int, int> labels;
+	Board relabelled(roomIds.size());
+	for (int r = 0; r < roomIds.size(); r++) {
+		relabelled[r].reserve(roomIds[r].size());
+		for (int roomId : roomIds[r]) {
+			// The next label, if the room is new.
+			int next = labels.size();
+			const auto& label = labels.insert({roomId, next}).first;
+			relabelled[r].push_back(label->second);
+		}
+	}
+	return relabelled;
+}
+
+Fingerprint fingerprintPuzzle(const Board& cellValues, const Board& roomIds) {
+	Board relabelled = relabelRooms(roomIds);
+	FingerprintBuilder builder;
+	builder.add(relabelled.size());
+	builder.add(relabelled.empty() ? 0 : relabelled[0].size());
+	for (int r = 0; r < relabelled.size(); r++) {
+		for (int c = 0; c < relabelled[r].size(); c++) {
+			// Both fit in 32 bits on any board that fits in memory.
+			builder.add((uint64_t)(uint32_t)relabelled[r][c] << 32 |
+						(uint32_t)cellValues[r][c]);
+		}
+	}
+	return builder.finish();
+}
+
+// Where transform `transform` of a board of `height` by `width` cells takes
+// cell (r, c) of the transformed board from.
+static Cell sourceOf(int transform, int r, int c, int height, int width) {
+	int sourceRow = transform & 4 ? c : r;
+	int sourceColumn = transform & 4 ? r : c;
+	if (transform & 1) sourceRow = height - 1 - sourceRow;
+	if (transform & 2) sourceColumn = width - 1 - sourceColumn;
+	return {sourceRow, sourceColumn};
+}
+
+Board transformBoard(const Board& board, int transform) {
+	int height = board.size();
+	int width = height ? board[0].size() : 0;
+	bool transposed = transform & 4;
+	Board transformed(transposed ? width : height,
+					  std::vector<int>(transposed ? height : width));
+	for (int r = 0; r < transformed.size(); r++) {
+		for (int c = 0; c < transformed[r].size(); c++) {
+			Cell source = sourceOf(transform, r, c, height, width);
+			transformed[r][c] = board[source.first][source.second];
+		}
+	}
+	return transformed;
+}
+
+Board untransformBoard(const Board& board, int transform) {
+	bool transposed = transform & 4;
+	int rows = board.size();
+	int columns = rows ? board[0].size() : 0;
+	int height = transposed ? columns : rows;
+	int width = transposed ? rows : columns;
+	Board original(height, std::vector<int>(width));
+	for (int r = 0; r < board.size(); r++) {
+		for (int c = 0; c < board[r].size(); c++) {
+			Cell source = sourceOf(transform, r, c, height, width);
+			original[source.first][source.second] = board[r][c];
+		}
+	}
+	return original;
+}
+
+CanonicalPuzzle canonicalizePuzzle(const Board& cellValues,
+								   const Board& roomIds) {
+	CanonicalPuzzle canonical;
+	int height = roomIds.size();
+	int width = height ? roomIds[0].size() : 0;
+	// With the rooms numbered densely, each transform can renumber them with a
+	// vector rather than a map.
+	Board rooms = relabelRooms(roomIds);
+	int roomCount = 0;
+	for (const auto& row : rooms) {
+		for (int room : row) {
+			roomCount = std::max(roomCount, room + 1);
+		}
+	}
+	std::vector<int> labels(roomCount);
+	// Each transform's dimensions, room IDs and clues, in the order they're
+	// compared.
+	std::vector<int> best, candidate;
+	for (int transform = 0; transform < kBoardTransforms; transform++) {
+		bool transposed = transform & 4;
+		int transformedHeight = transposed ? width : height;
+		int transformedWidth = transposed ? height : width;
+		candidate.clear();
+		candidate.push_back(transformedHeight);
+		candidate.push_back(transformedWidth);
+		std::fill(labels.begin(), labels.end(), -1);
+		int next = 0;
+		for (int r = 0; r < transformedHeight; r++) {
+			for (int c = 0; c < transformedWidth; c++) {
+				Cell source = sourceOf(transform, r, c, height, width);
+				int& label = labels[rooms[source.first][source.second]];
+				if (label == -1) label = next++;
+				candidate.push_back(label);
+			}
+		}
+		for (int r = 0; r < transformedHeight; r++) {
+			for (int c = 0; c < transformedWidth; c++) {
+				Cell source = sourceOf(transform, r, c, height, width);
+				candidate.push_back(cellValues[source.first][source.second]);
+			}
+		}
+		if (transform == 0 || candidate < best) {
+			best.swap(candidate);
+			canonical.transform = transform;
+		}
+	}
+
+	int canonicalHeight = best[0], canonicalWidth = best[1];
+	const int* roomLabels = &best[2];
+	const int* clues = roomLabels + canonicalHeight * canonicalWidth;
+	for (int r = 0; r < canonicalHeight; r++) {
+		canonical.roomIds.emplace_back(roomLabels + r * canonicalWidth,
+									   roomLabels + (r + 1) * canonicalWidth);
+		canonical.cellValues.emplace_back(clues + r * canonicalWidth,
+										  clues + (r + 1) * canonicalWidth);
+	}
+	return canonical;
+}
+
+Fingerprint canonicalFingerprint(const Board& cellValues,
+								 const Board& roomIds) {
+	CanonicalPuzzle canonical = canonicalizePuzzle(cellValues, roomIds);
+	return fingerprintPuzzle(canonical.cellValues, canonical.roomIds);
+}
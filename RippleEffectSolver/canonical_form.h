@@ -0,0 +1,89 @@
+//
+//  canonical_form.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef canonical_form_h
+#define canonical_form_h
+
+#include <cstddef>
+#include <cstdint>
+
+#include "typedefs.h"
+
+// Room IDs are only labels: two puzzles whose rooms cover the same cells and
+// whose clues match are the same puzzle, whatever numbers the rooms were
+// given. Renumbering the rooms in a fixed way gives every such puzzle the same
+// room IDs, so that it can be recognized.
+//
+// Rotating or reflecting a puzzle doesn't change it either, since the ripple
+// rule treats rows and columns alike and only counts distances, and its
+// solutions rotate and reflect along with it. Picking one of the eight ways of
+// turning it over in a fixed way, then renumbering its rooms, gives its
+// canonical form, which every rotation, reflection and numbering of it shares.
+
+// A 128-bit hash of a puzzle. Distinct puzzles get the same one with
+// probability around 2^-128 per pair, which is low enough to treat matching
+// fingerprints as matching puzzles.
+struct Fingerprint {
+	uint64_t high = 0;
+	uint64_t low = 0;
+
+	bool operator==(const Fingerprint& other) const {
+		return high == other.high && low == other.low;
+	}
+	bool operator!=(const Fingerprint& other) const {
+		return !(*this == other);
+	}
+	bool operator<(const Fingerprint& other) const {
+		return high != other.high ? high < other.high : low < other.low;
+	}
+};
+
+// For keeping fingerprints in hashed containers. They're hashes already.
+struct FingerprintHash {
+	size_t operator()(const Fingerprint& fingerprint) const {
+		return fingerprint.low;
+	}
+};
+
+// Renumbers the rooms 0, 1, 2, ... in the order their first cells come in,
+// reading row by row.
+Board relabelRooms(const Board& roomIds);
+
+// The fingerprint of a puzzle with the given clues and rooms, the same for
+// every numbering of the rooms. Covers the board's dimensions too.
+Fingerprint fingerprintPuzzle(const Board& cellValues, const Board& roomIds);
+
+// The rotations and reflections of a board, numbered 0 to 7. Transform t
+// transposes the board if bit 2 is set, then reverses the order of its rows if
+// bit 0 is set and of its columns if bit 1 is. 0 leaves it as it is.
+const int kBoardTransforms = 8;
+
+// Applies transform `transform` to `board`, and undoes it.
+Board transformBoard(const Board& board, int transform);
+Board untransformBoard(const Board& board, int transform);
+
+struct CanonicalPuzzle {
+	Board cellValues;
+	Board roomIds;
+	// The transform that turns the original puzzle into this one.
+	int transform = 0;
+};
+
+// The canonical form of a puzzle: of its eight transforms, each with its rooms
+// renumbered by relabelRooms, the one that comes first comparing dimensions,
+// then room IDs row by row, then clues row by row. The first transform to
+// reach it is the one recorded.
+CanonicalPuzzle canonicalizePuzzle(const Board& cellValues,
+								   const Board& roomIds);
+
+// The fingerprint of a puzzle's canonical form, the same for every rotation,
+// reflection and numbering of the rooms.
+Fingerprint canonicalFingerprint(const Board& cellValues,
+								 const Board& roomIds);
+
+#endif /* canonical_form_h */
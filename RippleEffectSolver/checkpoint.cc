@@ -0,0 +1,125 @@
+//
+//  checkpoint.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "checkpoint.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "typedefs.h"
+
+// Bumped whenever the format changes, so old files are rejected rather than
+// misread.
+static const int kCheckpointVersion = 1;
+
+static void writeList(FILE* file, const std::vector<int>& list) {
+	std::fprintf(file, " %zu", list.size());
+	for (int item : list) {
+		std::fprintf(file, " %d", item);
+	}
+	std::fprintf(file, "\n");
+}
+
+static bool readList(FILE* file, std::vector<int>* list) {
+	size_t size;
+	if (std::fscanf(file, "%zu", &size) != 1) {
+		return false;
+	}
+	list->resize(size);
+	for (int& item : *list) {
+		if (std::fscanf(file, "%d", &item) != 1) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void writeBoard(FILE* file, const Board& board) {
+	for (const auto& row : board) {
+		for (int c = 0; c < row.size(); c++) {
+			std::fprintf(file, c ? " %d" : "%d", row[c]);
+		}
+		std::fprintf(file, "\n");
+	}
+}
+
+static bool readBoard(FILE* file, size_t height, size_t width, Board* board) {
+	board->assign(height, std::vector<int>(width));
+	for (auto& row : *board) {
+		for (int& value : row) {
+			if (std::fscanf(file, "%d", &value) != 1) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool writeCheckpoint(const std::string& path,
+					 const SearchCheckpoint& checkpoint) {
+	std::string temporary = path + ".tmp";
+	FILE* file = std::fopen(temporary.c_str(), "w");
+	if (!file) {
+		return false;
+	}
+	const Board& board = checkpoint.board;
+	std::fprintf(file, "ripple-checkpoint %d\n", kCheckpointVersion);
+	std::fprintf(file, "%zu %zu\n", board.size(),
+				 board.empty() ? (size_t)0 : board[0].size());
+	writeBoard(file, board);
+	writeBoard(file, checkpoint.roomIds);
+	std::fprintf(file, "%lld %zu\n", checkpoint.visited,
+				 checkpoint.frames.size());
+	for (const auto& frame : checkpoint.frames) {
+		std::fprintf(file, "%d %d %d %d", frame.cell.first, frame.cell.second,
+					 frame.room, frame.next);
+		writeList(file, frame.room == -1 ? frame.values : frame.fillings);
+	}
+	bool written = !std::ferror(file);
+	written = std::fclose(file) == 0 && written;
+	if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+		std::remove(temporary.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool readCheckpoint(const std::string& path, SearchCheckpoint* checkpoint) {
+	FILE* file = std::fopen(path.c_str(), "r");
+	if (!file) {
+		return false;
+	}
+	int version;
+	size_t height, width, frames;
+	bool valid =
+		std::fscanf(file, "ripple-checkpoint %d", &version) == 1 &&
+		version == kCheckpointVersion &&
+		std::fscanf(file, "%zu %zu", &height, &width) == 2;
+	if (valid) {
+		valid = readBoard(file, height, width, &checkpoint->board) &&
+				readBoard(file, height, width, &checkpoint->roomIds) &&
+				std::fscanf(file, "%lld %zu", &checkpoint->visited, &frames) ==
+					2 &&
+				// Every choice fills in at least one cell.
+				frames <= height * width;
+	}
+	if (valid) {
+		checkpoint->frames.assign(frames, CheckpointFrame());
+		for (auto& frame : checkpoint->frames) {
+			valid = valid &&
+					std::fscanf(file, "%d %d %d %d", &frame.cell.first,
+								&frame.cell.second, &frame.room,
+								&frame.next) == 4 &&
+					readList(file, frame.room == -1 ? &frame.values
+													: &frame.fillings);
+		}
+	}
+	std::fclose(file);
+	return valid;
+}
@@ -0,0 +1,57 @@
+//
+//  checkpoint.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef checkpoint_h
+#define checkpoint_h
+
+#include <string>
+#include <vector>
+
+#include "typedefs.h"
+
+// One level of a paused search: the choices it was branching between and how
+// far through them it had got.
+struct CheckpointFrame {
+	// The cell branched on and its values in the order they're tried, or, if
+	// `room` isn't -1, the room filled in all at once and the indices of its
+	// fillings in that order.
+	Cell cell;
+	std::vector<int> values;
+	int room = -1;
+	std::vector<int> fillings;
+	// How many of the choices have been started. Every frame but the last is
+	// partway through choice `next` - 1, while the last is about to start
+	// choice `next`.
+	int next = 0;
+};
+
+// Everything needed to pick an enumeration back up where it left off. The
+// partial boards themselves aren't saved, since replaying the choices from
+// `board` rebuilds them.
+struct SearchCheckpoint {
+	// The board the search started from and its rooms, so that a checkpoint
+	// can't be resumed on a different one.
+	Board board;
+	Board roomIds;
+	// Solutions visited before the checkpoint was taken.
+	long long visited = 0;
+	// From the root down. Empty if the search hadn't branched yet.
+	std::vector<CheckpointFrame> frames;
+};
+
+// Saves `checkpoint` to `path` as text. The file is written under a temporary
+// name and then renamed over `path`, so a crash partway through leaves the
+// previous checkpoint intact. Returns false on failure.
+bool writeCheckpoint(const std::string& path,
+					 const SearchCheckpoint& checkpoint);
+
+// Loads a checkpoint saved by writeCheckpoint. Returns false if there's no
+// file at `path` or it isn't a valid checkpoint.
+bool readCheckpoint(const std::string& path, SearchCheckpoint* checkpoint);
+
+#endif /* checkpoint_h */
@@ -6,12 +6,16 @@
 //  Copyright © 2017 Hunter Knepshield. All rights reserved.
 //
 
+#include <chrono>
 #include <iostream>
 
 #include "augment_puzzle.h"
 #include "generate_puzzle.h"
+#include "minimize_clues.h"
 #include "read_input.h"
+#include "sample_solutions.h"
 #include "solve_puzzle.h"
+#include "solver_options.h"
 #include "typedefs.h"
 #include "validity_checks.h"
 
@@ -22,8 +26,51 @@ int verbosity = 1;
 // Verbosity settings that are passed to solving routines. 0 = silent, 1 = print
 // message on action, 2 = print message and board on action.
 int solvingVerbosity = 0;
+// Frequency settings. 0 = enumerate every solution to compute exact value
+// frequencies, n > 0 = estimate them from n randomly sampled solutions instead.
+// Sampling is the only option on boards with too many solutions to hold in
+// memory, but can't aggregate known cells. If frequencySampleSeconds is
+// positive, sampling also stops once it has taken that long, and setting it
+// alone samples for that long with no limit on the number of samples.
+int frequencySamples = 0;
+double frequencySampleSeconds = 0;
+// Solution set settings, ignored when sampling. false = hold every solution in
+// memory, true = compile solutions into a decision diagram, which shares the
+// structure common to many solutions and is usually far smaller.
+bool useSolutionDiagram = false;
+// Layout budget settings. Each is 0 for no limit. If checking whether a
+// generated layout can be solved takes more than layoutNodeBudget search nodes
+// or layoutTimeLimitSeconds seconds, the layout is abandoned like an
+// unsolvable one.
+long long layoutNodeBudget = 0;
+double layoutTimeLimitSeconds = 0;
+// Minimization settings. false = stop once the puzzle has a unique solution,
+// true = then take away every clue it doesn't need to stay unique, trying them
+// in minimizeOrder: 0 = reading order, 1 = reverse reading order, 2 = shuffled
+// by minimizeSeed. Up to minimizeThreads clues are checked at once (0 = one
+// per hardware thread), which doesn't change the result. If
+// minimizeNodeBudget is positive, a clue whose check takes more search nodes
+// than that is kept.
+bool minimizePuzzle = false;
+int minimizeThreads = 0;
+int minimizeOrder = 0;
+unsigned long long minimizeSeed = 0;
+long long minimizeNodeBudget = 0;
 
 int main(void) {
+	SamplingOptions samplingOptions;
+	samplingOptions.sampleCount = frequencySamples;
+	samplingOptions.timeBudgetSeconds = frequencySampleSeconds;
+	const SamplingOptions* sampling =
+		frequencySamples > 0 || frequencySampleSeconds > 0 ? &samplingOptions
+														   : nullptr;
+	MinimizeOptions minimizeOptions;
+	minimizeOptions.threads = minimizeThreads;
+	minimizeOptions.order = static_cast<RemovalOrder>(minimizeOrder);
+	minimizeOptions.seed = minimizeSeed;
+	minimizeOptions.nodeBudget = minimizeNodeBudget;
+	const MinimizeOptions* minimizing =
+		minimizePuzzle ? &minimizeOptions : nullptr;
 	while (true) {
 		//	std::cout
 		//		<< "Generate random puzzle (g) or augment existing instance (a)?
@@ -68,10 +115,26 @@ int main(void) {
 						std::cout
 							<< "This board is valid. Checking for a solution..."
 							<< std::endl;
+						SolveStatus status;
+						SolverOptions options;
+						options.status = &status;
+						options.nodeBudget = layoutNodeBudget;
+						if (layoutTimeLimitSeconds > 0) {
+							options.deadline =
+								std::chrono::steady_clock::now() +
+								std::chrono::duration_cast<
+									std::chrono::steady_clock::duration>(
+									std::chrono::duration<double>(
+										layoutTimeLimitSeconds));
+						}
 						const auto& solvedWithBoard = findSingleSolution(
 							cellValues, roomIds, roomMap, cellsCompletedInRoom,
-							solvingVerbosity);
-						if (!solvedWithBoard.first) {
+							solvingVerbosity, options);
+						if (status != SolveStatus::kFinished) {
+							std::cout << "Checking this board "
+									  << describeStatus(status)
+									  << ". Trying again..." << std::endl;
+						} else if (!solvedWithBoard.first) {
 							std::cout
 								<< "This board can't be solved. Trying again..."
 								<< std::endl;
@@ -80,7 +143,9 @@ int main(void) {
 										 "augmentation..."
 									  << std::endl;
 							return augmentPuzzle(cellValues, roomIds, verbosity,
-												 solvingVerbosity);
+												 solvingVerbosity, sampling,
+												 useSolutionDiagram,
+												 minimizing);
 						}
 					}
 				}
@@ -97,7 +162,8 @@ int main(void) {
 					return 1;
 				}
 				return augmentPuzzle(cellValues, roomIds, verbosity,
-									 solvingVerbosity);
+									 solvingVerbosity, sampling,
+									 useSolutionDiagram, minimizing);
 			}
 			default:
 				std::cerr << "Invalid choice.";
@@ -0,0 +1,93 @@
+//
+//  dedup_main.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include <iostream>
+#include <string>
+
+#include "board_writer.h"
+#include "canonical_form.h"
+#include "fingerprint_index.h"
+#include "ripple_effect.h"
+#include "typedefs.h"
+
+// Reads an archive of puzzles from stdin and writes every one that isn't a
+// duplicate of an earlier one to stdout. An archive is any number of puzzles in
+// the format the solver reads, one after another, so concatenated puzzle files
+// make one. Puzzles that are rotations or reflections of each other, or differ
+// only in how their rooms are numbered, are duplicates; see canonical_form.h.
+
+// Index settings. Empty = only look for duplicates within the archive, a file
+// name = also treat every puzzle recorded in that file by earlier runs as a
+// duplicate, and record the new ones there, so that archives can be
+// deduplicated against each other one at a time.
+std::string indexPath = "";
+
+// Output settings. false = write each puzzle kept the way it was read, true =
+// write its canonical form instead.
+bool writeCanonical = false;
+
+// Verbosity settings. 0 = silent, 1 = print counts to stderr at the end, 2 =
+// also print the number of every duplicate as it's found.
+int verbosity = 1;
+
+int main(void) {
+	FingerprintIndex index(indexPath);
+	if (!index.isOpen()) {
+		std::cerr << "Failed to open the index." << std::endl;
+		return 1;
+	}
+	size_t known = index.size();
+	long long read = 0, kept = 0;
+	std::string out;
+	while (!(std::cin >> std::ws).eof()) {
+		Board cellValues, roomIds;
+		std::string error;
+		if (!parsePuzzle(std::cin, &cellValues, &roomIds, &error)) {
+			std::cerr << "Puzzle " << read + 1 << ": " << error
+					  << " Terminating." << std::endl;
+			return 1;
+		}
+		read++;
+		CanonicalPuzzle canonical = canonicalizePuzzle(cellValues, roomIds);
+		if (!index.insert(
+				fingerprintPuzzle(canonical.cellValues, canonical.roomIds))) {
+			switch (verbosity) {
+				case 2:
+					std::cerr << "Puzzle " << read << " is a duplicate.\n";
+				default:
+					break;
+			}
+			continue;
+		}
+		kept++;
+		if (writeCanonical) {
+			appendPuzzle(canonical.cellValues, canonical.roomIds, &out);
+		} else {
+			appendPuzzle(cellValues, roomIds, &out);
+		}
+		if (out.size() >= 1 << 16) {
+			std::cout << out;
+			out.clear();
+		}
+	}
+	std::cout << out << std::flush;
+	if (!index.flush()) {
+		std::cerr << "Failed to write the index." << std::endl;
+		return 1;
+	}
+	switch (verbosity) {
+		case 2:
+		case 1:
+			std::cerr << "Read " << read << " puzzles and kept " << kept
+					  << ". The index held " << known << " before and "
+					  << index.size() << " after." << std::endl;
+		default:
+			break;
+	}
+	return 0;
+}
@@ -0,0 +1,85 @@
+//
+//  dig_puzzle.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "dig_puzzle.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "generate_puzzle.h"
+#include "minimize_clues.h"
+#include "solve_puzzle.h"
+#include "solver_options.h"
+#include "transposition_table.h"
+#include "typedefs.h"
+
+static const size_t kFillTranspositionEntries = 1 << 16;
+
+DugPuzzle digPuzzle(const Board& roomIds, uint64_t seed,
+					const DigOptions& options) {
+	DugPuzzle puzzle;
+	puzzle.roomIds = roomIds;
+	Board empty(roomIds.size(), std::vector<int>(roomIds[0].size()));
+
+	// Random value order with restarts, so that each seed fills the board in
+	// differently and one bad early choice doesn't sink the attempt. Most
+	// generated layouts can't be filled in at all, though, and line rules and
+	// room matching prove that in a small fraction of the nodes, with the
+	// transposition table keeping each attempt from proving it over again.
+	Solver solver(roomIds);
+	size_t largestRoom = 0;
+	for (const auto& roomAndCells : solver.roomMap()) {
+		largestRoom = std::max(largestRoom, roomAndCells.second.size());
+	}
+	TranspositionTable transpositionTable(
+		(int)roomIds.size(), (int)roomIds[0].size(), (int)largestRoom,
+		kFillTranspositionEntries);
+	SolveStatus status;
+	SolverOptions filling;
+	filling.stats = &puzzle.stats;
+	filling.status = &status;
+	filling.nodeBudget = options.fillNodeBudget;
+	filling.transpositionTable = &transpositionTable;
+	filling.lineRules = true;
+	filling.roomMatching = true;
+	filling.valueOrder = ValueOrder::kRandom;
+	filling.restartSchedule = RestartSchedule::kLuby;
+	filling.seed = seed;
+	bool filled;
+	std::tie(filled, puzzle.solution) =
+		solver.findSingleSolution(empty, 0, filling);
+	if (!filled) {
+		puzzle.solution.clear();
+		return puzzle;
+	}
+
+	// Digging checks one clue at a time; the threads go to other seeds.
+	MinimizeOptions digging;
+	digging.threads = 1;
+	digging.order = options.order;
+	digging.seed = seed;
+	digging.nodeBudget = options.checkNodeBudget;
+	MinimizeResult dug = minimizeClues(puzzle.solution, roomIds, digging);
+	addSolverStats(dug.stats, &puzzle.stats);
+	puzzle.generated = dug.unique;
+	puzzle.cellValues.swap(dug.cellValues);
+	puzzle.undecided = dug.undecided;
+	return puzzle;
+}
+
+DugPuzzle digPuzzle(int width, int height, uint64_t seed,
+					const DigOptions& options) {
+	std::seed_seq seeds = {(uint32_t)seed, (uint32_t)(seed >> 32)};
+	std::mt19937 random(seeds);
+	return digPuzzle(generatePuzzle(width, height, random, 0).second, seed,
+					 options);
+}
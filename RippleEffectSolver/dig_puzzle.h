@@ -0,0 +1,59 @@
+//
+//  dig_puzzle.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef dig_puzzle_h
+#define dig_puzzle_h
+
+#include <cstdint>
+
+#include "minimize_clues.h"
+#include "solver_options.h"
+#include "typedefs.h"
+
+// Makes puzzles without any help, solution first: fill in an empty board with
+// a randomized search, then dig clues out of the filled board for as long as
+// its solution stays unique. Digging is minimizeClues starting from every
+// cell, so the puzzles that come out are minimal unless a check runs out of
+// nodes.
+
+struct DigOptions {
+	// If positive, the most search nodes filling in the board may visit. Some
+	// layouts can't be filled in at all, and proving it can take a long time.
+	long long fillNodeBudget = 2000;
+	// If positive, the most search nodes any one search checking whether a
+	// clue can go may visit. A clue whose check runs out stays.
+	long long checkNodeBudget = 100000;
+	// The order clues are tried in. Random orders make for more varied
+	// puzzles from the same filled board.
+	RemovalOrder order = RemovalOrder::kRandom;
+};
+
+struct DugPuzzle {
+	// False if the board couldn't be filled in, in which case nothing else is
+	// filled in either.
+	bool generated = false;
+	Board cellValues;
+	Board roomIds;
+	Board solution;
+	// Clues kept only because their checks ran out of nodes.
+	int undecided = 0;
+	// What filling in the board and digging added up to.
+	SolverStats stats;
+};
+
+// Fills in a board with rooms `roomIds`, then digs clues out of it. The same
+// seed always gives the same puzzle.
+DugPuzzle digPuzzle(const Board& roomIds, uint64_t seed,
+					const DigOptions& options = DigOptions());
+
+// Generates a room layout the way generatePuzzle does, then digs a puzzle out
+// of it. Safe to call from several threads at once.
+DugPuzzle digPuzzle(int width, int height, uint64_t seed,
+					const DigOptions& options = DigOptions());
+
+#endif /* dig_puzzle_h */
@@ -0,0 +1,64 @@
+//
+//  fingerprint_index.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "fingerprint_index.h"
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "canonical_form.h"
+
+FingerprintIndex::FingerprintIndex(const std::string& path) {
+	if (path.empty()) {
+		return;
+	}
+	file = std::fopen(path.c_str(), "ab+");
+	if (!file) {
+		open = false;
+		return;
+	}
+	std::rewind(file);
+	uint64_t words[2];
+	long records = 0;
+	while (std::fread(words, sizeof(words), 1, file) == 1) {
+		Fingerprint fingerprint;
+		fingerprint.high = words[0];
+		fingerprint.low = words[1];
+		fingerprints.insert(fingerprint);
+		records++;
+	}
+	// A partial record at the end means a run was cut off while writing it.
+	// Dropping it loses only that fingerprint, and keeps the ones added after
+	// it in step.
+	open = !std::ferror(file) &&
+		   !ftruncate(fileno(file), records * sizeof(words)) &&
+		   !std::fseek(file, 0, SEEK_END);
+}
+
+FingerprintIndex::~FingerprintIndex() {
+	if (file) std::fclose(file);
+}
+
+bool FingerprintIndex::insert(const Fingerprint& fingerprint) {
+	if (!fingerprints.insert(fingerprint).second) {
+		return false;
+	}
+	if (file) {
+		uint64_t words[2] = {fingerprint.high, fingerprint.low};
+		if (std::fwrite(words, sizeof(words), 1, file) != 1) open = false;
+	}
+	return true;
+}
+
+bool FingerprintIndex::flush() {
+	if (file && std::fflush(file)) open = false;
+	return open;
+}
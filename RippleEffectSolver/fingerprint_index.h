@@ -0,0 +1,55 @@
+//
+//  fingerprint_index.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef fingerprint_index_h
+#define fingerprint_index_h
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <unordered_set>
+
+#include "canonical_form.h"
+
+// A set of puzzle fingerprints, optionally kept in a file so that it carries
+// over from one run to the next. The file is just the fingerprints, 16 bytes
+// each, in the order they were added; it's read in full when the index is
+// opened and appended to as fingerprints are added.
+class FingerprintIndex {
+   public:
+	// An index kept only in memory if `path` is empty, and otherwise kept in
+	// the file at `path`, which is created if it doesn't exist. Check isOpen()
+	// before use.
+	explicit FingerprintIndex(const std::string& path = "");
+	~FingerprintIndex();
+	FingerprintIndex(const FingerprintIndex&) = delete;
+	FingerprintIndex& operator=(const FingerprintIndex&) = delete;
+
+	// False if the file couldn't be read or opened for appending.
+	bool isOpen() const { return open; }
+
+	// Adds `fingerprint`. Returns false if it was already there. Writes to the
+	// file are buffered until flush() or destruction.
+	bool insert(const Fingerprint& fingerprint);
+
+	bool contains(const Fingerprint& fingerprint) const {
+		return fingerprints.count(fingerprint) > 0;
+	}
+
+	size_t size() const { return fingerprints.size(); }
+
+	// Writes out any buffered fingerprints. Returns false if that failed.
+	bool flush();
+
+   private:
+	std::unordered_set<Fingerprint, FingerprintHash> fingerprints;
+	FILE* file = nullptr;
+	bool open = true;
+};
+
+#endif /* fingerprint_index_h */
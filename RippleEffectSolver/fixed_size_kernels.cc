@@ -0,0 +1,281 @@
+//
+//  fixed_size_kernels.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "fixed_size_kernels.h"
+
+#include <algorithm>
+#include <map>
+
+#include "typedefs.h"
+
+// A copy of a board of kHeight rows and kWidth columns, none of whose rooms
+// have more than kMaxRoom cells, so that no value is more than kMaxRoom either.
+// The board is padded with kMaxRoom empty cells on every side, which no value
+// matches, so a ripple window never needs to check the board's edges.
+template <int kHeight, int kWidth, int kMaxRoom>
+class FixedSizeBoard {
+   public:
+	enum {
+		kStride = kWidth + 2 * kMaxRoom,
+		kCells = (kHeight + 2 * kMaxRoom) * kStride,
+	};
+
+	explicit FixedSizeBoard(const Board& cellValues) : cells() {
+		for (int r = 0; r < kHeight; r++) {
+			const int* row = cellValues[r].data();
+			for (int c = 0; c < kWidth; c++) {
+				cells[index(r, c)] = row[c];
+			}
+		}
+	}
+
+	static int index(int r, int c) {
+		return (r + kMaxRoom) * kStride + c + kMaxRoom;
+	}
+
+	static Cell cell(int index) {
+		return {index / kStride - kMaxRoom, index % kStride - kMaxRoom};
+	}
+
+	// Same as checkRow and checkColumn together, for an empty cell or one
+	// already holding `value`.
+	bool fits(int index, int value) const {
+		for (int distance = 1; distance <= kMaxRoom; distance++) {
+			if (distance > value) break;
+			if (cells[index - distance] == value ||
+				cells[index + distance] == value ||
+				cells[index - distance * kStride] == value ||
+				cells[index + distance * kStride] == value) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Same as fillKnownCellsInRoom, for the room whose cells are at `room`,
+	// writing every cell it fills in to `cellValues` as well.
+	int fillRoom(const int* room, int size, Board& cellValues,
+				 CellList* filledCells) {
+		int cellsFilled = 0;
+		bool modifiedRoom;
+		do {
+			modifiedRoom = false;
+			bool usedNumber[kMaxRoom + 1] = {};
+			int emptyCells[kMaxRoom];
+			int emptyCount = 0;
+			for (int i = 0; i < size; i++) {
+				int value = cells[room[i]];
+				if (value) {
+					usedNumber[value] = true;
+				} else {
+					emptyCells[emptyCount++] = room[i];
+				}
+			}
+			int possibleValues[kMaxRoom];
+			int possibleCount = 0;
+			for (int value = 1; value <= size; value++) {
+				if (!usedNumber[value]) {
+					possibleValues[possibleCount++] = value;
+				}
+			}
+
+			// Are there any empty cells that have just one possible value?
+			for (int i = 0; i < emptyCount; i++) {
+				int validPossibility = 0;
+				for (int j = 0; j < possibleCount; j++) {
+					if (fits(emptyCells[i], possibleValues[j])) {
+						if (validPossibility) {
+							validPossibility = 0;
+							break;
+						}
+						validPossibility = possibleValues[j];
+					}
+				}
+				if (validPossibility) {
+					set(emptyCells[i], validPossibility, cellValues,
+						filledCells);
+					cellsFilled++;
+					modifiedRoom = true;
+					possibleCount = std::remove(possibleValues,
+												possibleValues + possibleCount,
+												validPossibility) -
+									possibleValues;
+				}
+			}
+			emptyCount = std::remove_if(emptyCells, emptyCells + emptyCount,
+										[this](int index) {
+											return cells[index] != 0;
+										}) -
+						 emptyCells;
+
+			// Are there any missing values for this room that fit in only one
+			// cell?
+			for (int j = 0; j < possibleCount; j++) {
+				int onlyCell = -1;
+				for (int i = 0; i < emptyCount; i++) {
+					if (fits(emptyCells[i], possibleValues[j])) {
+						if (onlyCell != -1) {
+							onlyCell = -1;
+							break;
+						}
+						onlyCell = emptyCells[i];
+					}
+				}
+				if (onlyCell != -1) {
+					set(onlyCell, possibleValues[j], cellValues, filledCells);
+					cellsFilled++;
+					modifiedRoom = true;
+					emptyCount = std::remove(emptyCells,
+											 emptyCells + emptyCount,
+											 onlyCell) -
+								 emptyCells;
+				}
+			}
+		} while (modifiedRoom);
+		return cellsFilled;
+	}
+
+	int cells[kCells];
+
+   private:
+	void set(int index, int value, Board& cellValues, CellList* filledCells) {
+		cells[index] = value;
+		Cell filled = cell(index);
+		cellValues[filled.first][filled.second] = value;
+		if (filledCells) filledCells->push_back(filled);
+	}
+};
+
+template <int kHeight, int kWidth, int kMaxRoom>
+static void fillKnownCells(Board& cellValues, const RoomMap& roomMap,
+						   std::map<int, int>& cellsCompletedInRoom,
+						   CellList* filledCells) {
+	typedef FixedSizeBoard<kHeight, kWidth, kMaxRoom> FixedBoard;
+	FixedBoard board(cellValues);
+	// The rooms that aren't complete yet, in RoomMap order, as the indices of
+	// their cells in `board` and their entries in cellsCompletedInRoom.
+	int roomCells[kHeight * kWidth];
+	int roomStart[kHeight * kWidth + 1];
+	int* completedCells[kHeight * kWidth];
+	int rooms = 0;
+	roomStart[0] = 0;
+	for (const auto& roomAndCells : roomMap) {
+		int& completed = cellsCompletedInRoom[roomAndCells.first];
+		if (completed == roomAndCells.second.size()) continue;
+		int next = roomStart[rooms];
+		for (const auto& cell : roomAndCells.second) {
+			roomCells[next++] = FixedBoard::index(cell.first, cell.second);
+		}
+		completedCells[rooms] = &completed;
+		roomStart[++rooms] = next;
+	}
+
+	bool modifiedBoard;
+	do {
+		modifiedBoard = false;
+		for (int room = 0; room < rooms; room++) {
+			int size = roomStart[room + 1] - roomStart[room];
+			if (*completedCells[room] == size) continue;
+			int cellsFilled = board.fillRoom(&roomCells[roomStart[room]], size,
+											 cellValues, filledCells);
+			*completedCells[room] += cellsFilled;
+			if (cellsFilled > 0) {
+				modifiedBoard = true;
+			}
+		}
+	} while (modifiedBoard);
+}
+
+template <int kHeight, int kWidth, int kMaxRoom>
+static bool isSolved(const Board& cellValues, const RoomMap& roomMap) {
+	typedef FixedSizeBoard<kHeight, kWidth, kMaxRoom> FixedBoard;
+	FixedBoard board(cellValues);
+	for (int r = 0; r < kHeight; r++) {
+		for (int c = 0; c < kWidth; c++) {
+			int index = FixedBoard::index(r, c);
+			int value = board.cells[index];
+			// Bigger than any room, so it can't be right, and its window would
+			// reach past the padding.
+			if (value > kMaxRoom || !board.fits(index, value)) {
+				return false;
+			}
+		}
+	}
+	for (const auto& roomAndCells : roomMap) {
+		unsigned seen = 0;
+		for (const auto& cell : roomAndCells.second) {
+			unsigned bit = 1u << board.cells[FixedBoard::index(cell.first,
+															   cell.second)];
+			if (seen & bit) return false;
+			seen |= bit;
+		}
+	}
+	return true;
+}
+
+struct Specialization {
+	int height;
+	int width;
+	int maxRoom;
+	void (*fill)(Board&, const RoomMap&, std::map<int, int>&, CellList*);
+	bool (*solved)(const Board&, const RoomMap&);
+};
+
+#define SPECIALIZATION(height, width, maxRoom)     \
+	{height, width, maxRoom,                       \
+	 fillKnownCells<height, width, maxRoom>,       \
+	 isSolved<height, width, maxRoom>}
+
+// The board sizes with kernels of their own: the sizes of the puzzles here,
+// which are common ones. Each comes with a tight limit on room size, which
+// covers them, and a looser one. The first that fits a board is used.
+static const Specialization kSpecializations[] = {
+	SPECIALIZATION(7, 6, 6),   SPECIALIZATION(7, 6, 9),
+	SPECIALIZATION(10, 10, 6), SPECIALIZATION(10, 10, 9),
+	SPECIALIZATION(10, 18, 6), SPECIALIZATION(10, 18, 9),
+};
+
+#undef SPECIALIZATION
+
+static const Specialization* findSpecialization(const Board& cellValues,
+												const RoomMap& roomMap) {
+	int height = cellValues.size();
+	int width = height ? cellValues[0].size() : 0;
+	size_t largestRoom = 0;
+	for (const auto& roomAndCells : roomMap) {
+		largestRoom = std::max(largestRoom, roomAndCells.second.size());
+	}
+	for (const auto& specialization : kSpecializations) {
+		if (specialization.height == height &&
+			specialization.width == width &&
+			specialization.maxRoom >= largestRoom) {
+			return &specialization;
+		}
+	}
+	return nullptr;
+}
+
+bool fillKnownCellsFixedSize(Board& cellValues, const RoomMap& roomMap,
+							 std::map<int, int>& cellsCompletedInRoom,
+							 CellList* filledCells) {
+	const Specialization* specialization =
+		findSpecialization(cellValues, roomMap);
+	if (!specialization) return false;
+	specialization->fill(cellValues, roomMap, cellsCompletedInRoom,
+						 filledCells);
+	return true;
+}
+
+bool isSolvedFixedSize(const Board& cellValues, const RoomMap& roomMap,
+					   bool* solved) {
+	const Specialization* specialization =
+		findSpecialization(cellValues, roomMap);
+	if (!specialization) return false;
+	*solved = specialization->solved(cellValues, roomMap);
+	return true;
+}
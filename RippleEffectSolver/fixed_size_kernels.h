@@ -0,0 +1,40 @@
+//
+//  fixed_size_kernels.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef fixed_size_kernels_h
+#define fixed_size_kernels_h
+
+#include <map>
+
+#include "typedefs.h"
+
+// Versions of the search's two hottest loops, filling in known cells and
+// checking a complete board, compiled separately for the board sizes that come
+// up most. Each works on a copy of the board in a fixed-size array on the
+// stack, padded on every side by as many empty cells as the largest room has,
+// so that its height, width and ripple windows are all constants and no window
+// needs bounds checks.
+//
+// The specializations are listed in fixed_size_kernels.cc. Boards they don't
+// cover, or with rooms bigger than they allow, are left to the generic code;
+// both functions say whether they handled the board.
+
+// Same as fillKnownCellsInBoard with a verbosity of 0, filling in the same
+// cells in the same order. Returns false, having changed nothing, if there's
+// no specialization for the board.
+bool fillKnownCellsFixedSize(Board& cellValues, const RoomMap& roomMap,
+							 std::map<int, int>& cellsCompletedInRoom,
+							 CellList* filledCells);
+
+// Checks a board with no empty cells, and contiguous rooms, against the ripple
+// and room rules, setting `solved`. Returns false, leaving `solved` alone, if
+// there's no specialization for the board.
+bool isSolvedFixedSize(const Board& cellValues, const RoomMap& roomMap,
+					   bool* solved);
+
+#endif /* fixed_size_kernels_h */
@@ -9,26 +9,30 @@
 #include "generate_puzzle.h"
 
 #include <iostream>
+#include <limits>
 #include <numeric>
+#include <random>
 #include <set>
 #include <utility>
 
 #include "print_board.h"
 #include "typedefs.h"
 
-std::pair<Board, Board> generatePuzzle(int width, int height, int seed,
-									   int verbosity, int solvingVerbosity) {
+// Does the work for both versions of generatePuzzle. `roll` returns a random
+// number from 0 to the largest int.
+template <typename Roll>
+static std::pair<Board, Board> generateRooms(int width, int height, Roll roll,
+											 int verbosity) {
 	Board cellValues, roomIds;
 	for (int r = 0; r < height; r++) {
 		cellValues.emplace_back(width);
 		roomIds.emplace_back(width);
 	}
-	std::srand(seed);
 
 	int newRoomId = 1;
 
 	int maxInt = std::numeric_limits<int>::max();
-	// We will expand a room 50% of the time. If rand() returns a value
+	// We will expand a room 50% of the time. If roll() returns a value
 	// below this threshold, we'll expand an existing room.
 	int defaultLimit = maxInt / 5 * 4;
 	// Puzzles with huge amounts of big numbers aren't very exciting.
@@ -51,7 +55,7 @@ std::pair<Board, Board> generatePuzzle(int width, int height, int seed,
 				roomId = roomIds[r][c - 1];
 			} else {
 				// Roll to determine if we take from above or below.
-				roomId = std::rand() < maxInt / 2 ? roomIds[r - 1][c]
+				roomId = roll() < maxInt / 2 ? roomIds[r - 1][c]
 												  : roomIds[r][c - 1];
 			}
 			if (roomId != 0) {
@@ -65,9 +69,9 @@ std::pair<Board, Board> generatePuzzle(int width, int height, int seed,
 					// since this is integer division.
 					int adjustedLimit =
 						defaultLimit / maxRoomSize * (maxRoomSize - roomSize);
-					expand = std::rand() < adjustedLimit;
+					expand = roll() < adjustedLimit;
 				} else {
-					expand = std::rand() < defaultLimit;
+					expand = roll() < defaultLimit;
 				}
 				roomIds[r][c] = expand ? roomId : newRoomId++;
 			}
@@ -352,3 +356,18 @@ std::pair<Board, Board> generatePuzzle(int width, int height, int seed,
 
 	return {cellValues, roomIds};
 }
+
+std::pair<Board, Board> generatePuzzle(int width, int height, int seed,
+									   int verbosity, int solvingVerbosity) {
+	std::srand(seed);
+	return generateRooms(
+		width, height, []() { return std::rand(); }, verbosity);
+}
+
+std::pair<Board, Board> generatePuzzle(int width, int height,
+									   std::mt19937& random, int verbosity) {
+	// The top 31 bits, which span exactly 0 to the largest int.
+	return generateRooms(
+		width, height, [&random]() { return (int)(random() >> 1); },
+		verbosity);
+}
@@ -9,6 +9,7 @@
 #ifndef generate_puzzle_h
 #define generate_puzzle_h
 
+#include <random>
 #include <utility>
 
 #include "typedefs.h"
@@ -18,4 +19,9 @@
 std::pair<Board, Board> generatePuzzle(int width, int height, int seed,
 									   int verbosity, int solvingVerbosity);
 
+// Generates a board the same way, but draws from `random` rather than rand(),
+// so that several threads can generate boards at once.
+std::pair<Board, Board> generatePuzzle(int width, int height,
+									   std::mt19937& random, int verbosity);
+
 #endif /* generate_puzzle_h */
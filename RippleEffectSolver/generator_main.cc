@@ -0,0 +1,156 @@
+//
+//  generator_main.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "board_writer.h"
+#include "canonical_form.h"
+#include "dig_puzzle.h"
+#include "fingerprint_index.h"
+#include "solve_puzzle.h"
+#include "typedefs.h"
+
+// Generates puzzles without any input, one seed at a time on every thread,
+// and writes them to stdout as an archive in the format the solver reads (see
+// dedup_main.cc). Each seed gives a room layout, which is filled in and then
+// has clues dug out of it; see dig_puzzle.h. Most layouts can't be filled in,
+// so most seeds don't give a puzzle. A seed always gives the same puzzle, but
+// puzzles are written in the order they're finished.
+
+// Size settings. Every puzzle is puzzleWidth cells wide and puzzleHeight
+// cells tall.
+int puzzleWidth = 10;
+int puzzleHeight = 10;
+// Count settings. Seeds firstSeed, firstSeed + 1, ... are tried until
+// puzzleCount puzzles have come out, or seedLimit seeds have been tried if
+// that's positive.
+long long puzzleCount = 100;
+unsigned long long firstSeed = 1;
+long long seedLimit = 100000;
+// Thread settings. 0 = one per hardware thread.
+int threadCount = 0;
+// Budget settings; see DigOptions. A layout that takes more than
+// fillNodeBudget search nodes to fill in is passed over, and a clue that takes
+// more than checkNodeBudget search nodes to check is kept.
+long long fillNodeBudget = 2000;
+long long checkNodeBudget = 100000;
+// Duplicate settings. false = write every puzzle generated, true = skip any
+// that's the same as an earlier one up to rotation, reflection and room
+// numbering (see canonical_form.h).
+bool skipDuplicates = true;
+// Verbosity settings. 0 = silent, 1 = print counts and rates to stderr at the
+// end, 2 = also print the seed and clue count of every puzzle as it's written.
+int verbosity = 1;
+
+int main(void) {
+	int threads = threadCount;
+	if (threads <= 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	DigOptions options;
+	options.fillNodeBudget = fillNodeBudget;
+	options.checkNodeBudget = checkNodeBudget;
+
+	auto start = std::chrono::steady_clock::now();
+	std::atomic<long long> seedsTried(0);
+	// Everything below is guarded by outputMutex.
+	std::mutex outputMutex;
+	long long written = 0, duplicates = 0, undecided = 0, clues = 0;
+	FingerprintIndex index;
+	std::string out;
+	std::vector<std::thread> workers;
+	for (int t = 0; t < threads; t++) {
+		workers.emplace_back([&]() {
+			while (true) {
+				{
+					std::lock_guard<std::mutex> lock(outputMutex);
+					if (written >= puzzleCount) return;
+				}
+				long long tried = seedsTried++;
+				if (seedLimit > 0 && tried >= seedLimit) return;
+				uint64_t seed = firstSeed + tried;
+				DugPuzzle puzzle =
+					digPuzzle(puzzleWidth, puzzleHeight, seed, options);
+				if (!puzzle.generated) continue;
+				Fingerprint fingerprint;
+				if (skipDuplicates) {
+					fingerprint =
+						canonicalFingerprint(puzzle.cellValues, puzzle.roomIds);
+				}
+
+				std::lock_guard<std::mutex> lock(outputMutex);
+				if (written >= puzzleCount) return;
+				if (skipDuplicates && !index.insert(fingerprint)) {
+					duplicates++;
+					continue;
+				}
+				written++;
+				undecided += puzzle.undecided;
+				int given = countKnownCells(puzzle.cellValues);
+				clues += given;
+				appendPuzzle(puzzle.cellValues, puzzle.roomIds, &out);
+				if (out.size() >= 1 << 16) {
+					std::cout << out;
+					out.clear();
+				}
+				switch (verbosity) {
+					case 2:
+						std::cerr << "Seed " << seed << ": a puzzle with "
+								  << given << " clues.\n";
+					default:
+						break;
+				}
+			}
+		});
+	}
+	for (auto& worker : workers) {
+		worker.join();
+	}
+	std::cout << out << std::flush;
+
+	double seconds = std::chrono::duration<double>(
+						 std::chrono::steady_clock::now() - start)
+						 .count();
+	long long tried = seedsTried;
+	if (seedLimit > 0) tried = std::min(tried, seedLimit);
+	switch (verbosity) {
+		case 2:
+		case 1:
+			std::cerr << "Generated " << written << " puzzles of "
+					  << puzzleWidth << "x" << puzzleHeight << " from " << tried
+					  << " seeds in " << seconds << " seconds on " << threads
+					  << " threads: " << written / seconds
+					  << " puzzles per second, " << written / seconds / threads
+					  << " per thread." << std::endl;
+			if (written > 0) {
+				std::cerr << "The puzzles average " << (double)clues / written
+						  << " clues." << std::endl;
+			}
+			if (duplicates > 0) {
+				std::cerr << "Skipped " << duplicates << " duplicate puzzles."
+						  << std::endl;
+			}
+			if (undecided > 0) {
+				std::cerr << undecided
+						  << " clues were only kept because checking them ran "
+							 "out of nodes, so some puzzles may not be minimal."
+						  << std::endl;
+			}
+		default:
+			break;
+	}
+	return written < puzzleCount ? 1 : 0;
+}
@@ -0,0 +1,83 @@
+//
+//  layout_cache.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "layout_cache.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "room_tables.h"
+#include "typedefs.h"
+#include "validity_checks.h"
+
+std::shared_ptr<const Layout> buildLayout(const Board& roomIds,
+										  int roomTableMaxCells) {
+	std::shared_ptr<Layout> layout = std::make_shared<Layout>();
+	layout->roomIds = roomIds;
+	for (int r = 0; r < roomIds.size(); r++) {
+		for (int c = 0; c < roomIds[r].size(); c++) {
+			layout->roomMap[roomIds[r][c]].push_back({r, c});
+		}
+	}
+	layout->roomsValid = validateRooms(roomIds, layout->roomMap);
+	for (const auto& roomAndCells : layout->roomMap) {
+		layout->largestRoom =
+			std::max(layout->largestRoom, roomAndCells.second.size());
+	}
+	layout->roomTableMaxCells = roomTableMaxCells;
+	if (roomTableMaxCells > 0) {
+		layout->roomTables.reset(
+			new RoomTables(layout->roomMap, roomTableMaxCells));
+	}
+	return layout;
+}
+
+LayoutCache::LayoutCache(size_t capacity)
+	: capacity(std::max(capacity, (size_t)1)) {}
+
+std::shared_ptr<const Layout> LayoutCache::get(const Board& roomIds,
+											   int roomTableMaxCells) {
+	Key key(roomTableMaxCells, roomIds);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		const auto& entry = entries.find(key);
+		if (entry != entries.end()) {
+			hitCount++;
+			recent.splice(recent.begin(), recent, entry->second.second);
+			return entry->second.first;
+		}
+		missCount++;
+	}
+	std::shared_ptr<const Layout> layout =
+		buildLayout(roomIds, roomTableMaxCells);
+	std::lock_guard<std::mutex> lock(mutex);
+	const auto& entry = entries.find(key);
+	if (entry != entries.end()) {
+		// Another thread got there first.
+		return entry->second.first;
+	}
+	recent.push_front(key);
+	entries[key] = {layout, recent.begin()};
+	if (entries.size() > capacity) {
+		entries.erase(recent.back());
+		recent.pop_back();
+	}
+	return layout;
+}
+
+long long LayoutCache::hits() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return hitCount;
+}
+
+long long LayoutCache::misses() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return missCount;
+}
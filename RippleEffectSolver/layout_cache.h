@@ -0,0 +1,71 @@
+//
+//  layout_cache.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef layout_cache_h
+#define layout_cache_h
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "room_tables.h"
+#include "typedefs.h"
+
+// Everything about a room layout that doesn't depend on the clues, worked out
+// once so that solving many boards with the same rooms can skip it.
+struct Layout {
+	Board roomIds;
+	RoomMap roomMap;
+	// Whether every room is contiguous.
+	bool roomsValid = false;
+	size_t largestRoom = 0;
+	// Tables for every room of up to `roomTableMaxCells` cells, or null if
+	// that's 0.
+	int roomTableMaxCells = 0;
+	std::unique_ptr<const RoomTables> roomTables;
+};
+
+// Works out the layout of `roomIds` from scratch.
+std::shared_ptr<const Layout> buildLayout(const Board& roomIds,
+										  int roomTableMaxCells);
+
+// Keeps the most recently used layouts, keyed by their room IDs and table size.
+// Safe to share between threads. Layouts are handed out as shared pointers, so
+// one evicted while still in use stays alive until its last user is done.
+class LayoutCache {
+   public:
+	// Holds at most `capacity` layouts (minimum 1).
+	explicit LayoutCache(size_t capacity);
+
+	// The layout of `roomIds` with tables for rooms of up to
+	// `roomTableMaxCells` cells, building it if it isn't cached. The lock isn't
+	// held while building, so two threads missing on the same layout at once
+	// may both build it; only one copy is kept.
+	std::shared_ptr<const Layout> get(const Board& roomIds,
+									  int roomTableMaxCells);
+
+	// Lookups that found the layout cached, and that didn't.
+	long long hits() const;
+	long long misses() const;
+
+   private:
+	typedef std::pair<int, Board> Key;
+	typedef std::list<Key>::iterator Position;
+
+	mutable std::mutex mutex;
+	size_t capacity;
+	// Most recently used first.
+	std::list<Key> recent;
+	std::map<Key, std::pair<std::shared_ptr<const Layout>, Position>> entries;
+	long long hitCount = 0, missCount = 0;
+};
+
+#endif /* layout_cache_h */
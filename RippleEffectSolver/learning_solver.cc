@@ -0,0 +1,470 @@
+//
+//  learning_solver.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "learning_solver.h"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "print_board.h"
+#include "solver_options.h"
+#include "typedefs.h"
+
+// Conflicts allowed before the first restart. The nth restart waits that many
+// times the nth term of the Luby sequence (1, 1, 2, 1, 1, 2, 4, ...).
+static const int kRestartBase = 100;
+
+LearningSolver::LearningSolver(const Board& cellValues, const Board& roomIds,
+							   const RoomMap& roomMap, int verbosity,
+							   const SolverOptions& options)
+	: roomIds(roomIds),
+	  verbosity(verbosity),
+	  stats(options.stats),
+	  options(options) {
+	int height = (int)cellValues.size(), width = (int)cellValues[0].size();
+	int variables = 0, largestRoom = 0;
+	firstVariable.assign(height, std::vector<int>(width));
+	for (int r = 0; r < height; r++) {
+		for (int c = 0; c < width; c++) {
+			int size = (int)roomMap.at(roomIds[r][c]).size();
+			largestRoom = std::max(largestRoom, size);
+			firstVariable[r][c] = variables;
+			for (int value = 1; value <= size; value++) {
+				variableCell.push_back({r, c});
+				variableValue.push_back(value);
+			}
+			variables += size;
+		}
+	}
+	assignment.assign(variables, 2);
+	level.assign(variables, 0);
+	reason.assign(variables, -1);
+	activity.assign(variables, 0);
+	// Trying a value in a cell is a far stronger choice than ruling one out.
+	savedPhase.assign(variables, 1);
+	watches.resize(2 * variables);
+
+	// Each cell holds exactly one of its room's values.
+	for (int r = 0; r < height; r++) {
+		for (int c = 0; c < width; c++) {
+			int size = (int)roomMap.at(roomIds[r][c]).size();
+			std::vector<int> atLeastOne;
+			for (int value = 1; value <= size; value++) {
+				atLeastOne.push_back(2 * variableFor(r, c, value));
+				for (int other = value + 1; other <= size; other++) {
+					addClause({2 * variableFor(r, c, value) + 1,
+							   2 * variableFor(r, c, other) + 1},
+							  ClauseKind::kCell);
+				}
+			}
+			addClause(atLeastOne, ClauseKind::kCell);
+		}
+	}
+
+	// Each room holds each of its values in exactly one cell.
+	for (const auto& roomAndCells : roomMap) {
+		const CellList& cellsInRoom = roomAndCells.second;
+		for (int value = 1; value <= cellsInRoom.size(); value++) {
+			std::vector<int> atLeastOne;
+			for (int i = 0; i < cellsInRoom.size(); i++) {
+				const Cell& cell = cellsInRoom[i];
+				atLeastOne.push_back(
+					2 * variableFor(cell.first, cell.second, value));
+				for (int j = i + 1; j < cellsInRoom.size(); j++) {
+					const Cell& other = cellsInRoom[j];
+					addClause(
+						{2 * variableFor(cell.first, cell.second, value) + 1,
+						 2 * variableFor(other.first, other.second, value) + 1},
+						ClauseKind::kRoom);
+				}
+			}
+			addClause(atLeastOne, ClauseKind::kRoom);
+		}
+	}
+
+	// Two equal values in a row or column need at least that many cells
+	// between them. Looking only right and down covers every pair once.
+	for (int r = 0; r < height; r++) {
+		for (int c = 0; c < width; c++) {
+			int size = (int)roomMap.at(roomIds[r][c]).size();
+			for (int distance = 1; distance <= largestRoom; distance++) {
+				Cell others[] = {{r, c + distance}, {r + distance, c}};
+				for (const auto& other : others) {
+					if (other.first >= height || other.second >= width) {
+						continue;
+					}
+					int otherSize =
+						(int)roomMap.at(roomIds[other.first][other.second])
+							.size();
+					for (int value = distance;
+						 value <= std::min(size, otherSize); value++) {
+						int first = variableFor(r, c, value);
+						int second =
+							variableFor(other.first, other.second, value);
+						addClause({2 * first + 1, 2 * second + 1},
+								  ClauseKind::kRipple);
+					}
+				}
+			}
+		}
+	}
+
+	// Finally, the values we were given.
+	for (int r = 0; r < height && satisfiable; r++) {
+		for (int c = 0; c < width; c++) {
+			int value = cellValues[r][c];
+			if (!value) continue;
+			if (value > roomMap.at(roomIds[r][c]).size()) {
+				satisfiable = false;
+				break;
+			}
+			addClause({2 * variableFor(r, c, value)}, ClauseKind::kCell);
+		}
+	}
+	if (satisfiable && propagate() != -1) {
+		satisfiable = false;
+	}
+	maxLearned = clauses.size() / 3.0;
+}
+
+const char* LearningSolver::describe(ClauseKind kind) {
+	switch (kind) {
+		case ClauseKind::kCell:
+			return "a cell";
+		case ClauseKind::kRoom:
+			return "a room";
+		case ClauseKind::kRipple:
+			return "a ripple";
+		case ClauseKind::kLearned:
+			return "a learned";
+		case ClauseKind::kBlocking:
+			return "an earlier solution's";
+	}
+	return "a";
+}
+
+int LearningSolver::addClause(std::vector<int> literals, ClauseKind kind) {
+	if (literals.size() == 1) {
+		switch (literalValue(literals[0])) {
+			case 0:
+				satisfiable = false;
+				break;
+			case 2:
+				enqueue(literals[0], -1);
+			default:
+				break;
+		}
+		return -1;
+	}
+	int index = (int)clauses.size();
+	watches[literals[0]].push_back(index);
+	watches[literals[1]].push_back(index);
+	clauses.push_back({std::move(literals), kind, 0, false});
+	return index;
+}
+
+void LearningSolver::enqueue(int literal, int reasonClause) {
+	int variable = literal >> 1;
+	assignment[variable] = !(literal & 1);
+	level[variable] = decisionLevel();
+	reason[variable] = reasonClause;
+	trail.push_back(literal);
+}
+
+int LearningSolver::propagate() {
+	while (propagated < trail.size()) {
+		// Everything watching the literal that just became false needs
+		// another literal to watch, or is now unit or broken.
+		int falseLiteral = trail[propagated++] ^ 1;
+		std::vector<int>& watching = watches[falseLiteral];
+		size_t kept = 0;
+		for (size_t i = 0; i < watching.size(); i++) {
+			int index = watching[i];
+			Clause& clause = clauses[index];
+			if (clause.deleted) continue;
+			std::vector<int>& literals = clause.literals;
+			if (literals[0] == falseLiteral) {
+				std::swap(literals[0], literals[1]);
+			}
+			if (literalValue(literals[0]) == 1) {
+				watching[kept++] = index;
+				continue;
+			}
+			bool moved = false;
+			for (int k = 2; k < literals.size(); k++) {
+				if (literalValue(literals[k]) != 0) {
+					std::swap(literals[1], literals[k]);
+					watches[literals[1]].push_back(index);
+					moved = true;
+					break;
+				}
+			}
+			if (moved) continue;
+			watching[kept++] = index;
+			if (literalValue(literals[0]) == 0) {
+				// Broken. Keep the rest of the watches as they are.
+				for (i++; i < watching.size(); i++) {
+					watching[kept++] = watching[i];
+				}
+				watching.resize(kept);
+				propagated = trail.size();
+				return index;
+			}
+			enqueue(literals[0], index);
+		}
+		watching.resize(kept);
+	}
+	return -1;
+}
+
+std::vector<int> LearningSolver::analyze(int conflict, int* backjumpLevel) {
+	// Walk back along the trail, replacing each literal assigned at the
+	// current level with the reasons it was forced, until only one is left:
+	// the first unique implication point.
+	std::vector<int> learned(1);
+	std::vector<bool> seen(assignment.size(), false);
+	int pending = 0, literal = -1;
+	size_t position = trail.size();
+	do {
+		Clause& clause = clauses[conflict];
+		bumpClause(clause);
+		for (int j = literal == -1 ? 0 : 1; j < clause.literals.size(); j++) {
+			int variable = clause.literals[j] >> 1;
+			if (seen[variable] || level[variable] == 0) continue;
+			seen[variable] = true;
+			bumpVariable(variable);
+			if (level[variable] == decisionLevel()) {
+				pending++;
+			} else {
+				learned.push_back(clause.literals[j]);
+			}
+		}
+		do {
+			literal = trail[--position];
+		} while (!seen[literal >> 1]);
+		conflict = reason[literal >> 1];
+		pending--;
+	} while (pending > 0);
+	learned[0] = literal ^ 1;
+
+	// Jump back to the latest level among the rest, which goes second so
+	// that it's watched.
+	*backjumpLevel = 0;
+	for (int i = 1; i < learned.size(); i++) {
+		if (level[learned[i] >> 1] > *backjumpLevel) {
+			*backjumpLevel = level[learned[i] >> 1];
+			std::swap(learned[1], learned[i]);
+		}
+	}
+	return learned;
+}
+
+void LearningSolver::backtrack(int targetLevel) {
+	if (decisionLevel() <= targetLevel) return;
+	for (size_t i = trail.size(); i-- > trailLimits[targetLevel];) {
+		int variable = trail[i] >> 1;
+		savedPhase[variable] = assignment[variable];
+		assignment[variable] = 2;
+		reason[variable] = -1;
+	}
+	trail.resize(trailLimits[targetLevel]);
+	trailLimits.resize(targetLevel);
+	propagated = trail.size();
+}
+
+int LearningSolver::pickBranchVariable() const {
+	int best = -1;
+	for (int variable = 0; variable < assignment.size(); variable++) {
+		if (assignment[variable] == 2 &&
+			(best == -1 || activity[variable] > activity[best])) {
+			best = variable;
+		}
+	}
+	return best;
+}
+
+void LearningSolver::bumpVariable(int variable) {
+	activity[variable] += variableIncrement;
+	if (activity[variable] > 1e100) {
+		for (auto& value : activity) {
+			value *= 1e-100;
+		}
+		variableIncrement *= 1e-100;
+	}
+}
+
+void LearningSolver::bumpClause(Clause& clause) {
+	if (clause.kind != ClauseKind::kLearned) return;
+	clause.activity += clauseIncrement;
+	if (clause.activity > 1e20) {
+		for (auto& other : clauses) {
+			if (other.kind == ClauseKind::kLearned) other.activity *= 1e-20;
+		}
+		clauseIncrement *= 1e-20;
+	}
+}
+
+void LearningSolver::reduceLearned() {
+	std::vector<int> candidates;
+	for (int i = 0; i < clauses.size(); i++) {
+		const Clause& clause = clauses[i];
+		if (clause.kind != ClauseKind::kLearned || clause.deleted ||
+			clause.literals.size() <= 2) {
+			continue;
+		}
+		// Clauses that are the reason for a current assignment must stay.
+		int first = clause.literals[0];
+		if (reason[first >> 1] == i && literalValue(first) == 1) continue;
+		candidates.push_back(i);
+	}
+	std::sort(candidates.begin(), candidates.end(), [this](int a, int b) {
+		return clauses[a].activity < clauses[b].activity;
+	});
+	for (int i = 0; i < candidates.size() / 2; i++) {
+		// Watch lists drop deleted clauses as propagation comes across them.
+		clauses[candidates[i]].deleted = true;
+		clauses[candidates[i]].literals.clear();
+		learnedCount--;
+	}
+	maxLearned *= 1.1;
+}
+
+Board LearningSolver::currentBoard() const {
+	Board board(firstVariable.size(),
+				std::vector<int>(firstVariable[0].size(), 0));
+	for (int variable = 0; variable < assignment.size(); variable++) {
+		if (assignment[variable] == 1) {
+			const Cell& cell = variableCell[variable];
+			board[cell.first][cell.second] = variableValue[variable];
+		}
+	}
+	return board;
+}
+
+bool LearningSolver::solve(Board* solution) {
+	lastStatus = SolveStatus::kFinished;
+	if (!satisfiable) {
+		return false;
+	}
+	while (true) {
+		lastStatus = checkBudgets(options, decisions);
+		if (lastStatus != SolveStatus::kFinished) {
+			return false;
+		}
+		int conflict = propagate();
+		if (conflict != -1) {
+			if (stats) stats->conflicts++;
+			conflictsSinceRestart++;
+			if (decisionLevel() == 0) {
+				// Broken without making any choices, so there's nothing left.
+				satisfiable = false;
+				return false;
+			}
+			int backjumpLevel;
+			ClauseKind kind = clauses[conflict].kind;
+			std::vector<int> learned = analyze(conflict, &backjumpLevel);
+			switch (verbosity) {
+				case 2:
+					printBoard(currentBoard(), roomIds);
+				case 1:
+					std::cout << "Broke " << describe(kind)
+							  << " constraint. Learned a nogood over "
+							  << learned.size() << " cell values and jumped "
+							  << "back from choice " << decisionLevel()
+							  << " to choice " << backjumpLevel << "."
+							  << std::endl;
+				default:
+					break;
+			}
+			backtrack(backjumpLevel);
+			if (learned.size() == 1) {
+				enqueue(learned[0], -1);
+			} else {
+				int index = addClause(learned, ClauseKind::kLearned);
+				bumpClause(clauses[index]);
+				enqueue(learned[0], index);
+				learnedCount++;
+			}
+			if (stats) stats->learnedNogoods++;
+			variableIncrement /= 0.95;
+			clauseIncrement /= 0.999;
+			continue;
+		}
+
+		if (conflictsSinceRestart >= kRestartBase * lubyTerm(restarts)) {
+			// Keep what we learned, but start choosing again from scratch.
+			restarts++;
+			conflictsSinceRestart = 0;
+			backtrack(0);
+			if (stats) stats->restarts++;
+			switch (verbosity) {
+				case 2:
+				case 1:
+					std::cout << "Restarting the search, keeping "
+							  << learnedCount << " learned nogoods."
+							  << std::endl;
+				default:
+					break;
+			}
+			continue;
+		}
+		if (learnedCount >= maxLearned + trail.size()) {
+			reduceLearned();
+		}
+
+		int variable = pickBranchVariable();
+		if (variable == -1) {
+			// Everything is assigned and nothing is broken.
+			*solution = currentBoard();
+			return true;
+		}
+		decisions++;
+		if (stats) {
+			stats->nodes++;
+			stats->branches++;
+		}
+		int literal = 2 * variable + (savedPhase[variable] ? 0 : 1);
+		trailLimits.push_back((int)trail.size());
+		enqueue(literal, -1);
+		switch (verbosity) {
+			case 2:
+				printBoard(currentBoard(), roomIds);
+			case 1:
+				std::cout << "Branching by "
+						  << (literal & 1 ? "ruling out" : "filling")
+						  << " (" << variableCell[variable].first + 1 << ", "
+						  << variableCell[variable].second + 1 << ") "
+						  << (literal & 1 ? "as" : "with") << " value "
+						  << variableValue[variable] << "." << std::endl;
+			default:
+				break;
+		}
+	}
+}
+
+void LearningSolver::blockSolution(const Board& solution) {
+	backtrack(0);
+	std::vector<int> literals;
+	for (int r = 0; r < solution.size(); r++) {
+		for (int c = 0; c < solution[r].size(); c++) {
+			int variable = variableFor(r, c, solution[r][c]);
+			// Values known without any choices are in every solution, so
+			// leave them out.
+			if (assignment[variable] != 1) {
+				literals.push_back(2 * variable + 1);
+			}
+		}
+	}
+	if (literals.empty()) {
+		satisfiable = false;
+		return;
+	}
+	addClause(literals, ClauseKind::kBlocking);
+}
@@ -0,0 +1,142 @@
+//
+//  learning_solver.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef learning_solver_h
+#define learning_solver_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "solver_options.h"
+#include "typedefs.h"
+
+// A search engine that learns from its mistakes, as an alternative to the
+// backtracking search in solve_puzzle.cc (see SearchEngine in
+// solver_options.h).
+//
+// The board is encoded as clauses over one true/false variable per (cell,
+// value) pair: every cell holds some value, every room holds each of its values
+// somewhere, no cell or room doubles up, and no two equal values break the
+// ripple rule. Every value the engine deduces remembers the constraint that
+// forced it. When a constraint is broken, the engine follows those reasons
+// back to a nogood, a small combination of choices that can never appear in a
+// solution, adds it as a new clause, and jumps straight back to the most recent
+// choice that nogood involves rather than just undoing the last one. It
+// restarts on a Luby schedule, keeping what it learned, and throws out the
+// least useful half of its nogoods whenever there are too many.
+//
+// This is the conflict-driven clause learning that SAT solvers use. It shines
+// on boards where the backtracking search keeps failing in the same way in
+// sibling subtrees, but it has more overhead per choice.
+class LearningSolver {
+   public:
+	// Sets up the clauses for the board. Only the `stats`, cancellation and
+	// budget options are used, and they must outlive the solver. The node
+	// budget covers every call to solve() together.
+	LearningSolver(const Board& cellValues, const Board& roomIds,
+				   const RoomMap& roomMap, int verbosity,
+				   const SolverOptions& options);
+
+	// Looks for a solution that hasn't been ruled out by blockSolution().
+	// Returns false if there isn't one, or if the search was cancelled or ran
+	// out of budget first. Every choice counts as a search node.
+	bool solve(Board* solution);
+
+	// How the last call to solve() ended.
+	SolveStatus status() const { return lastStatus; }
+
+	// Rules out `solution` (which must have come from solve()) so that the
+	// next call finds a different one.
+	void blockSolution(const Board& solution);
+
+   private:
+	// What a clause says, for verbose output.
+	enum class ClauseKind { kCell, kRoom, kRipple, kLearned, kBlocking };
+	struct Clause {
+		std::vector<int> literals;
+		ClauseKind kind;
+		double activity;
+		bool deleted;
+	};
+
+	static const char* describe(ClauseKind kind);
+
+	// Literals are 2 * variable for "holds", and 2 * variable + 1 for
+	// "doesn't hold".
+	int variableFor(int r, int c, int value) const {
+		return firstVariable[r][c] + value - 1;
+	}
+	// 1 if the literal is true, 0 if false, 2 if its variable is unassigned.
+	int literalValue(int literal) const {
+		int assigned = assignment[literal >> 1];
+		return assigned == 2 ? 2 : assigned ^ (literal & 1);
+	}
+	int decisionLevel() const { return (int)trailLimits.size(); }
+
+	// Adds a clause of `literals` and returns its index. The first two
+	// literals get watched, so they must be unassigned, or for a learned
+	// nogood, the one it forces and the latest of the rest. A single literal
+	// is enqueued straight away instead (returning -1).
+	int addClause(std::vector<int> literals, ClauseKind kind);
+	// Makes `literal` true, forced by clause `reason` (-1 for a choice).
+	void enqueue(int literal, int reason);
+	// Unit propagation with two watched literals per clause. Returns the
+	// index of a broken clause, or -1.
+	int propagate();
+	// Works back from the broken clause to a nogood that becomes unit once
+	// backjumped to `*backjumpLevel`.
+	std::vector<int> analyze(int conflict, int* backjumpLevel);
+	void backtrack(int level);
+	// The unassigned variable with the highest activity, or -1.
+	int pickBranchVariable() const;
+	void bumpVariable(int variable);
+	void bumpClause(Clause& clause);
+	// Deletes the less active half of the learned clauses.
+	void reduceLearned();
+	// The board as currently assigned, with 0 for undecided cells.
+	Board currentBoard() const;
+
+	const Board& roomIds;
+	int verbosity;
+	SolverStats* stats;
+	const SolverOptions& options;
+	SolveStatus lastStatus = SolveStatus::kFinished;
+	// Choices made over every call to solve().
+	long long decisions = 0;
+	// False once the clauses are known to contradict each other outright.
+	bool satisfiable = true;
+
+	std::vector<std::vector<int>> firstVariable;
+	std::vector<Cell> variableCell;
+	std::vector<int> variableValue;
+
+	std::vector<Clause> clauses;
+	// For each literal, the clauses watching it, i.e. with it in one of their
+	// first two places.
+	std::vector<std::vector<int>> watches;
+	// Per variable: 0, 1 or 2 (unassigned), its decision level, the clause
+	// that forced it (or -1), its activity and its last value.
+	std::vector<uint8_t> assignment;
+	std::vector<int> level, reason;
+	std::vector<double> activity;
+	std::vector<uint8_t> savedPhase;
+	// Every true literal in assignment order, where each decision level
+	// starts, and how much of it propagation has been through.
+	std::vector<int> trail, trailLimits;
+	size_t propagated = 0;
+
+	double variableIncrement = 1, clauseIncrement = 1;
+	size_t learnedCount = 0;
+	double maxLearned = 0;
+	// Restart schedule position, and conflicts since the last restart.
+	int restarts = 0;
+	long long conflictsSinceRestart = 0;
+};
+
+#endif /* learning_solver_h */
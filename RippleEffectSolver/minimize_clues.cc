@@ -0,0 +1,282 @@
+//
+//  minimize_clues.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "minimize_clues.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "solve_puzzle.h"
+#include "solver_options.h"
+#include "typedefs.h"
+#include "validity_checks.h"
+
+// Handing a batch of checks out to threads takes tens of microseconds, so
+// while checks take less than this on average, they're run one at a time.
+static const double kParallelCheckSeconds = 1e-4;
+
+// What checking a clue found.
+enum class Verdict {
+	kNeeded,
+	kRedundant,
+	// A search ran out of nodes before it could tell.
+	kUndecided,
+};
+
+// What one thread checks clues with. Every board checked has the same rooms,
+// so its solver's memory carries over from one check to the next.
+struct Checker {
+	explicit Checker(const Board& roomIds) : solver(roomIds) {}
+
+	Solver solver;
+	FillScratch scratch;
+	std::map<int, int> completed;
+	SolverStats stats;
+	long long propagationChecks = 0;
+	// The board being checked, and a copy to fill in known cells on.
+	Board board;
+	Board filled;
+};
+
+static SolverOptions searchOptions(const MinimizeOptions& options,
+								   Checker& checker, SolveStatus* status) {
+	SolverOptions searching;
+	searching.stats = &checker.stats;
+	searching.status = status;
+	searching.nodeBudget = options.nodeBudget;
+	return searching;
+}
+
+// Fills in known cells on a copy of `checker.board`, into `checker.filled`.
+static void fillKnownCells(Checker& checker, const Board& roomIds) {
+	const RoomMap& roomMap = checker.solver.roomMap();
+	checker.filled = checker.board;
+	checker.completed.clear();
+	for (const auto& room : roomMap) {
+		int& completed = checker.completed[room.first];
+		for (const auto& cell : room.second) {
+			if (checker.board[cell.first][cell.second]) completed++;
+		}
+	}
+	fillKnownCellsInBoard(checker.filled, roomIds, roomMap, checker.completed,
+						  0, nullptr, &checker.scratch);
+}
+
+// Whether `solution` is the only solution to `checker.board`, given that it
+// was the only one before `cell` was cleared, which is all that's changed.
+// Then any other solution has some other value at `cell`, so only those need
+// searching for, and often filling in known cells puts the clue straight back.
+static Verdict checkClearedCell(Checker& checker, const Board& roomIds,
+								const Board& solution, const Cell& cell,
+								const MinimizeOptions& options) {
+	fillKnownCells(checker, roomIds);
+	if (checker.filled[cell.first][cell.second]) {
+		checker.propagationChecks++;
+		return Verdict::kRedundant;
+	}
+
+	const RoomMap& roomMap = checker.solver.roomMap();
+	Board& board = checker.board;
+	const CellList& cellsInRoom = roomMap.at(roomIds[cell.first][cell.second]);
+	int answer = solution[cell.first][cell.second];
+	Verdict verdict = Verdict::kRedundant;
+	for (int value = 1; value <= (int)cellsInRoom.size(); value++) {
+		if (value == answer || !checkRow(cell, value, board) ||
+			!checkColumn(cell, value, board) ||
+			!checkRoom(cell, cellsInRoom, value, board)) {
+			continue;
+		}
+		board[cell.first][cell.second] = value;
+		SolveStatus status;
+		bool solved =
+			checker.solver
+				.findSingleSolution(board, 0,
+									searchOptions(options, checker, &status))
+				.first;
+		board[cell.first][cell.second] = 0;
+		if (solved) return Verdict::kNeeded;
+		if (status != SolveStatus::kFinished) verdict = Verdict::kUndecided;
+	}
+	return verdict;
+}
+
+// Whether `checker.board` has exactly one solution.
+static Verdict checkUnique(Checker& checker, const Board& roomIds,
+						   const MinimizeOptions& options) {
+	fillKnownCells(checker, roomIds);
+	if (countKnownCells(checker.filled) ==
+		checker.filled.size() * checker.filled[0].size()) {
+		checker.propagationChecks++;
+		return Verdict::kRedundant;
+	}
+	SolveStatus status;
+	long long count = checker.solver.countSolutions(
+		checker.board, 0, 2, searchOptions(options, checker, &status));
+	if (count > 1) return Verdict::kNeeded;
+	return status == SolveStatus::kFinished ? Verdict::kRedundant
+											: Verdict::kUndecided;
+}
+
+MinimizeResult minimizeClues(const Board& cellValues, const Board& roomIds,
+							 const MinimizeOptions& options) {
+	auto start = std::chrono::steady_clock::now();
+	MinimizeResult result;
+	result.cellValues = cellValues;
+	result.cluesBefore = result.cluesAfter = countKnownCells(cellValues);
+	result.threads = options.threads;
+	if (result.threads <= 0) {
+		result.threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	std::vector<std::unique_ptr<Checker>> checkers;
+	checkers.emplace_back(new Checker(roomIds));
+
+	// Everything below depends on knowing the one solution there is.
+	{
+		Checker& checker = *checkers[0];
+		SolveStatus status;
+		SolverOptions searching = searchOptions(options, checker, &status);
+		if (checker.solver.countSolutions(cellValues, 0, 2, searching) == 1 &&
+			status == SolveStatus::kFinished) {
+			result.solution =
+				checker.solver.findSingleSolution(cellValues, 0, searching)
+					.second;
+			result.unique = status == SolveStatus::kFinished;
+		}
+	}
+	if (result.unique) {
+		for (int i = 1; i < result.threads; i++) {
+			checkers.emplace_back(new Checker(roomIds));
+		}
+	}
+
+	std::deque<Cell> pending;
+	for (int r = 0; r < cellValues.size(); r++) {
+		for (int c = 0; c < cellValues[r].size(); c++) {
+			if (result.unique && cellValues[r][c]) pending.emplace_back(r, c);
+		}
+	}
+	if (options.order == RemovalOrder::kReverseReadingOrder) {
+		std::reverse(pending.begin(), pending.end());
+	} else if (options.order == RemovalOrder::kRandom) {
+		std::mt19937_64 random(options.seed);
+		std::shuffle(pending.begin(), pending.end(), random);
+	}
+
+	Board& board = result.cellValues;
+	long long removed = 0, kept = 0;
+	// How long the checks so far took, added up.
+	double checkSeconds = 0;
+	while (!pending.empty()) {
+		// Guess that the clues before each one in the batch all go if most
+		// clues have gone so far, and that they all stay otherwise. Either way
+		// the first clue in the batch is checked against the real board.
+		bool optimistic = removed > kept;
+		size_t batchSize = 1;
+		if (result.checks && checkSeconds >= kParallelCheckSeconds *
+												 result.checks) {
+			batchSize = std::min<size_t>(result.threads, pending.size());
+		}
+		std::vector<Cell> batch(pending.begin(), pending.begin() + batchSize);
+		pending.erase(pending.begin(), pending.begin() + batch.size());
+		std::vector<Verdict> verdicts(batch.size());
+		std::vector<double> seconds(batch.size());
+		auto check = [&](size_t i, Checker& checker) {
+			auto started = std::chrono::steady_clock::now();
+			checker.board = board;
+			for (size_t j = optimistic ? 0 : i; j <= i; j++) {
+				checker.board[batch[j].first][batch[j].second] = 0;
+			}
+			// Only a board with one clue fewer than the unique one is sure to
+			// have had a unique solution before the clue went.
+			verdicts[i] = i == 0 || !optimistic
+							  ? checkClearedCell(checker, roomIds,
+												 result.solution, batch[i],
+												 options)
+							  : checkUnique(checker, roomIds, options);
+			seconds[i] = std::chrono::duration<double>(
+							 std::chrono::steady_clock::now() - started)
+							 .count();
+		};
+		if (batch.size() == 1) {
+			check(0, *checkers[0]);
+		} else {
+			std::atomic<size_t> next(0);
+			std::vector<std::thread> threads;
+			for (size_t t = 0; t < batch.size(); t++) {
+				threads.emplace_back([&, t]() {
+					for (size_t i = next++; i < batch.size(); i = next++) {
+						check(i, *checkers[t]);
+					}
+				});
+			}
+			for (auto& thread : threads) {
+				thread.join();
+			}
+		}
+		result.checks += batch.size();
+		result.batches++;
+		for (double checked : seconds) {
+			checkSeconds += checked;
+		}
+
+		// Go through the verdicts in order, as if checking one at a time. A
+		// verdict on a board with fewer clues than the real one still says a
+		// clue can go, and one on a board with more still says it's needed,
+		// but taking a clue away only keeps to the order if every clue before
+		// it has been settled.
+		std::vector<Cell> unsettled;
+		bool allRemoved = true, anyRemoved = false;
+		for (size_t i = 0; i < batch.size(); i++) {
+			bool exact = unsettled.empty() &&
+						 (optimistic ? allRemoved : !anyRemoved);
+			bool settled;
+			switch (verdicts[i]) {
+				case Verdict::kRedundant:
+					settled = unsettled.empty() && (optimistic || exact);
+					break;
+				case Verdict::kNeeded:
+					settled = optimistic ? exact : true;
+					break;
+				default:
+					settled = exact;
+			}
+			const Cell& cell = batch[i];
+			if (!settled) {
+				unsettled.push_back(cell);
+				allRemoved = false;
+				result.repeatedChecks++;
+			} else if (verdicts[i] == Verdict::kRedundant) {
+				board[cell.first][cell.second] = 0;
+				removed++;
+				anyRemoved = true;
+			} else {
+				kept++;
+				allRemoved = false;
+				if (verdicts[i] == Verdict::kUndecided) result.undecided++;
+			}
+		}
+		pending.insert(pending.begin(), unsettled.begin(), unsettled.end());
+	}
+
+	result.cluesAfter = countKnownCells(board);
+	for (const auto& checker : checkers) {
+		addSolverStats(checker->stats, &result.stats);
+		result.propagationChecks += checker->propagationChecks;
+	}
+	result.seconds = std::chrono::duration<double>(
+						 std::chrono::steady_clock::now() - start)
+						 .count();
+	return result;
+}
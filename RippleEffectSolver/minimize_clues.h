@@ -0,0 +1,84 @@
+//
+//  minimize_clues.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef minimize_clues_h
+#define minimize_clues_h
+
+#include <cstdint>
+
+#include "solver_options.h"
+#include "typedefs.h"
+
+// Once a puzzle has a unique solution, some of its clues may be redundant:
+// taking one away leaves the solution unique all the same. A puzzle is minimal
+// once every clue it has left is needed. minimizeClues gets there greedily,
+// going through the clues in a fixed order and taking each one away unless the
+// puzzle needs it.
+//
+// Taking clues away never rules solutions out, so a clue that's needed stays
+// needed however many others are taken away after it. That lets several clues
+// be checked at once, each against a guess at the board it would be checked
+// against one at a time: either that every clue before it in the batch is
+// kept, or that every one is taken away. Whenever the guess turns out wrong
+// but the answer would be the same on the real board, the answer stands;
+// otherwise the clue is checked again in the next batch. So the result is the
+// same as checking one clue at a time, however many threads check them.
+
+// The order clues are tried in.
+enum class RemovalOrder {
+	// Row by row, top to bottom and left to right.
+	kReadingOrder,
+	kReverseReadingOrder,
+	// Shuffled, according to MinimizeOptions::seed.
+	kRandom,
+};
+
+struct MinimizeOptions {
+	// The most clues to check at once, each on its own thread. 0 = one per
+	// hardware thread.
+	int threads = 0;
+	RemovalOrder order = RemovalOrder::kReadingOrder;
+	uint64_t seed = 0;
+	// If positive, the most search nodes any one search may visit. A clue
+	// whose check runs out is kept, so the puzzle is still unique but may not
+	// be minimal.
+	long long nodeBudget = 0;
+};
+
+struct MinimizeResult {
+	// False if the puzzle didn't have exactly one solution to begin with (or
+	// checking that ran out of nodes), in which case no clues were removed.
+	bool unique = false;
+	Board cellValues;
+	// The solution, if unique.
+	Board solution;
+	int cluesBefore = 0;
+	int cluesAfter = 0;
+	// Clues kept only because their checks ran out of nodes.
+	int undecided = 0;
+	// Checks run, how many of those filling in known cells settled without a
+	// search, and how many were run again because their guess went wrong in a
+	// way that mattered.
+	long long checks = 0;
+	long long propagationChecks = 0;
+	long long repeatedChecks = 0;
+	// Batches of checks run at once, and the threads they were run on.
+	long long batches = 0;
+	int threads = 0;
+	double seconds = 0;
+	// What every search run added up to.
+	SolverStats stats;
+};
+
+// Takes away every clue in `cellValues` that isn't needed to keep its solution
+// unique, trying them in the order `options` gives.
+MinimizeResult minimizeClues(
+	const Board& cellValues, const Board& roomIds,
+	const MinimizeOptions& options = MinimizeOptions());
+
+#endif /* minimize_clues_h */
@@ -0,0 +1,128 @@
+//
+//  perf_counters.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "perf_counters.h"
+
+#include "solver_options.h"
+
+#if defined(PERF_COUNTERS) && defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#endif /* PERF_COUNTERS && __linux__ */
+
+const char* describePerfCounter(int counter) {
+	switch (counter) {
+		case kTaskClock:
+			return "CPU nanoseconds";
+		case kCycles:
+			return "cycles";
+		case kInstructions:
+			return "instructions";
+		case kCacheMisses:
+			return "cache misses";
+		case kBranchMisses:
+			return "branch misses";
+		default:
+			return "?";
+	}
+}
+
+#if defined(PERF_COUNTERS) && defined(__linux__)
+
+// The calling thread's counters, opened the first time it asks and closed when
+// it exits. Counters the kernel refuses stay at -1.
+class ThreadCounters {
+   public:
+	ThreadCounters() {
+		static const uint32_t kTypes[kPerfCounters] = {
+			PERF_TYPE_SOFTWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+			PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE};
+		static const uint64_t kConfigs[kPerfCounters] = {
+			PERF_COUNT_SW_TASK_CLOCK, PERF_COUNT_HW_CPU_CYCLES,
+			PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+			PERF_COUNT_HW_BRANCH_MISSES};
+		for (int i = 0; i < kPerfCounters; i++) {
+			perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = kTypes[i];
+			attr.config = kConfigs[i];
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			fds[i] = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+		}
+	}
+
+	~ThreadCounters() {
+		for (int fd : fds) {
+			if (fd != -1) close(fd);
+		}
+	}
+
+	bool available(int counter) const { return fds[counter] != -1; }
+
+	// Reads every counter into `values`, leaving 0 for unavailable ones.
+	void read(long long* values) const {
+		for (int i = 0; i < kPerfCounters; i++) {
+			uint64_t value = 0;
+			if (fds[i] != -1 &&
+				::read(fds[i], &value, sizeof(value)) != sizeof(value)) {
+				value = 0;
+			}
+			values[i] = (long long)value;
+		}
+	}
+
+   private:
+	int fds[kPerfCounters];
+};
+
+static const ThreadCounters& threadCounters() {
+	static thread_local ThreadCounters counters;
+	return counters;
+}
+
+bool perfCounterAvailable(int counter) {
+	return threadCounters().available(counter);
+}
+
+PerfScope::PerfScope(PerfPhase phase, SolverStats* stats)
+	: counts(stats ? &stats->perf[(int)phase] : nullptr) {
+	if (counts) threadCounters().read(start);
+}
+
+PerfScope::~PerfScope() {
+	if (!counts) return;
+	long long end[kPerfCounters];
+	threadCounters().read(end);
+	counts->calls++;
+	for (int i = 0; i < kPerfCounters; i++) {
+		counts->values[i] += end[i] - start[i];
+	}
+}
+
+#elif defined(PERF_COUNTERS) /* !__linux__ */
+
+bool perfCounterAvailable(int counter) { return false; }
+
+PerfScope::PerfScope(PerfPhase phase, SolverStats* stats)
+	: counts(stats ? &stats->perf[(int)phase] : nullptr) {}
+
+PerfScope::~PerfScope() {
+	if (counts) counts->calls++;
+}
+
+#else /* !PERF_COUNTERS */
+
+bool perfCounterAvailable(int counter) { return false; }
+
+#endif /* PERF_COUNTERS && __linux__ */
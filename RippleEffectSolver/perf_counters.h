@@ -0,0 +1,77 @@
+//
+//  perf_counters.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef perf_counters_h
+#define perf_counters_h
+
+// If you want to know where the search's time goes at the hardware level,
+// uncomment this #define (or build with -DPERF_COUNTERS) and the searches will
+// count CPU time, cycles, instructions, cache misses and branch misses for each
+// phase below, which printSolverStats then reports. It uses Linux's
+// perf_event_open, so elsewhere, or where the kernel won't allow it, the
+// counters come out as unavailable. Reading them takes a few system calls per
+// phase, which slows the search down considerably, so leave it off otherwise.
+// Left off, it compiles away to nothing.
+// #define PERF_COUNTERS
+
+struct SolverStats;
+
+// The parts of a backtracking search that are counted separately. None of them
+// overlap, and the learning engine isn't counted.
+enum class PerfPhase {
+	// Filling in known cells (and probing) at each search node.
+	kPropagation,
+	// Choosing how to branch, and setting up each child's board.
+	kBranching,
+	// Checking whether a board is solved.
+	kValidation,
+	// Handing each solution found to whatever collects them.
+	kAggregation,
+};
+const int kPerfPhases = 4;
+
+// What is counted, in the order PerfCounts stores them.
+enum PerfCounter {
+	// Nanoseconds of CPU time.
+	kTaskClock,
+	kCycles,
+	kInstructions,
+	kCacheMisses,
+	kBranchMisses,
+};
+const int kPerfCounters = 5;
+
+// Totals for one phase.
+struct PerfCounts {
+	long long calls = 0;
+	long long values[kPerfCounters] = {};
+};
+
+// A short name for `counter`, such as "cache misses".
+const char* describePerfCounter(int counter);
+
+// Whether `counter` could be opened on this thread.
+bool perfCounterAvailable(int counter);
+
+// Counts everything from its construction to its destruction as one call of
+// `phase`, adding the result to `stats` (if not null).
+class PerfScope {
+   public:
+#ifdef PERF_COUNTERS
+	PerfScope(PerfPhase phase, SolverStats* stats);
+	~PerfScope();
+
+   private:
+	PerfCounts* counts;
+	long long start[kPerfCounters];
+#else  /* !PERF_COUNTERS */
+	PerfScope(PerfPhase, SolverStats*) {}
+#endif /* PERF_COUNTERS */
+};
+
+#endif /* perf_counters_h */
@@ -0,0 +1,152 @@
+//
+//  portfolio.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "portfolio.h"
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "solve_puzzle.h"
+#include "solver_options.h"
+#include "typedefs.h"
+
+// Runs `search(options)` once per configuration, each on its own thread, and
+// keeps the result of the first to finish. Every other search is cancelled
+// then, through `alsoCancelled` so that each configuration's own `cancelled`
+// still stops it too. Searches that stop early on their own budgets don't
+// count. Returns the winning index, or -1 if none finished.
+template <typename Result, typename Search>
+static int race(const std::vector<SolverOptions>& configurations,
+				const Search& search, Result* result) {
+	std::atomic<bool> done(false);
+	std::mutex resultMutex;
+	int winner = -1;
+	std::vector<SolverStats> stats(configurations.size());
+	std::vector<SolveStatus> statuses(configurations.size());
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < configurations.size(); i++) {
+		threads.emplace_back([&, i]() {
+			SolverOptions options = configurations[i];
+			options.alsoCancelled = &done;
+			options.stats = &stats[i];
+			options.status = &statuses[i];
+			Result found = search(options);
+			std::lock_guard<std::mutex> lock(resultMutex);
+			if (winner == -1 && statuses[i] == SolveStatus::kFinished) {
+				winner = (int)i;
+				*result = std::move(found);
+				done = true;
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	for (size_t i = 0; i < configurations.size(); i++) {
+		if (configurations[i].stats) {
+			addSolverStats(stats[i], configurations[i].stats);
+		}
+		if (configurations[i].status) {
+			*configurations[i].status = statuses[i];
+		}
+	}
+	return winner;
+}
+
+static void announceWinner(int winner, int verbosity) {
+	if (winner == -1) return;
+	switch (verbosity) {
+		case 2:
+		case 1:
+			std::cout << "Portfolio configuration " << winner
+					  << " answered first." << std::endl;
+		default:
+			break;
+	}
+}
+
+std::pair<bool, Board> findSingleSolutionPortfolio(
+	const Board& cellValues, const Board& roomIds, const RoomMap& roomMap,
+	const std::map<int, int>& cellsCompletedInRoom, int verbosity,
+	const std::vector<SolverOptions>& configurations, int* winner) {
+	std::pair<bool, Board> result(false, Board());
+	int first = race(
+		configurations,
+		[&](const SolverOptions& options) {
+			return findSingleSolution(cellValues, roomIds, roomMap,
+									  cellsCompletedInRoom, 0, options);
+		},
+		&result);
+	announceWinner(first, verbosity);
+	if (winner) *winner = first;
+	return result;
+}
+
+long long countSolutionsPortfolio(
+	const Board& cellValues, const Board& roomIds, const RoomMap& roomMap,
+	const std::map<int, int>& cellsCompletedInRoom, int verbosity,
+	long long limit, const std::vector<SolverOptions>& configurations,
+	int* winner) {
+	long long result = 0;
+	int first = race(
+		configurations,
+		[&](const SolverOptions& options) {
+			return countSolutions(cellValues, roomIds, roomMap,
+								  cellsCompletedInRoom, 0, limit, options);
+		},
+		&result);
+	announceWinner(first, verbosity);
+	if (winner) *winner = first;
+	return result;
+}
+
+std::vector<SolverOptions> defaultPortfolio(int threads, uint64_t seed,
+											const RoomTables* roomTables) {
+	std::vector<SolverOptions> configurations;
+	configurations.push_back(SolverOptions());
+
+	SolverOptions learning;
+	learning.engine = SearchEngine::kLearning;
+	configurations.push_back(learning);
+
+	SolverOptions reasoning;
+	reasoning.lineRules = true;
+	reasoning.roomMatching = true;
+	reasoning.valueOrder = ValueOrder::kLeastConstraining;
+	configurations.push_back(reasoning);
+
+	if (roomTables) {
+		SolverOptions tables;
+		tables.roomTables = roomTables;
+		tables.roomBranching = true;
+		tables.valueOrder = ValueOrder::kRandom;
+		tables.restartSchedule = RestartSchedule::kLuby;
+		tables.seed = seed;
+		configurations.push_back(tables);
+	}
+
+	for (int i = 0; (int)configurations.size() < threads; i++) {
+		SolverOptions probing;
+		probing.lineRules = true;
+		probing.probeBudget = 1000;
+		probing.valueOrder = ValueOrder::kSmallestFootprint;
+		probing.restartSchedule = RestartSchedule::kGeometric;
+		probing.seed = seed + 1 + i;
+		configurations.push_back(probing);
+	}
+	if ((int)configurations.size() > threads) {
+		configurations.resize(threads > 0 ? threads : 0);
+	}
+	return configurations;
+}
@@ -0,0 +1,64 @@
+//
+//  portfolio.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef portfolio_h
+#define portfolio_h
+
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "solver_options.h"
+#include "typedefs.h"
+
+class RoomTables;
+
+// Which configuration works best varies a lot from board to board, and a
+// search that gets unlucky early can take far longer than one that doesn't. A
+// portfolio sidesteps both by running several differently configured searches
+// side by side, one thread each, and taking whichever answers first; the rest
+// are cancelled as soon as it does.
+//
+// Each configuration is used as is, budgets and `cancelled` flag included,
+// except that its `alsoCancelled` flag is replaced with the portfolio's own,
+// and its counters and status are collected per thread and passed on to its
+// own `stats` and `status` (if any) once every thread is done. A search that
+// stops early on its own budget or `cancelled` flag can't win, so giving every
+// configuration the same `cancelled` flag cancels the whole portfolio.
+// Transposition tables aren't safe to share between threads, so no two
+// configurations may use the same one.
+
+// Like findSingleSolution, but racing every configuration in `configurations`
+// against each other. If `winner` is not null, it is set to the index of the
+// configuration that answered, or -1 if none finished. Searches run silently;
+// at verbosity 1 or more, the winner is announced.
+std::pair<bool, Board> findSingleSolutionPortfolio(
+	const Board& cellValues, const Board& roomIds, const RoomMap& roomMap,
+	const std::map<int, int>& cellsCompletedInRoom, int verbosity,
+	const std::vector<SolverOptions>& configurations, int* winner = nullptr);
+
+// Like countSolutions, but racing every configuration in `configurations`
+// against each other. Every configuration must count the same thing, so this
+// mostly pays off on unsatisfiable boards or with a small `limit`, where how
+// fast a dead end is recognized matters most.
+long long countSolutionsPortfolio(
+	const Board& cellValues, const Board& roomIds, const RoomMap& roomMap,
+	const std::map<int, int>& cellsCompletedInRoom, int verbosity,
+	long long limit, const std::vector<SolverOptions>& configurations,
+	int* winner = nullptr);
+
+// A spread of `threads` configurations that tend to struggle on different
+// boards: the plain search, the learning engine, line rules with room matching
+// and the least constraining value, room tables with room branching (if
+// `roomTables` is not null), and then probing with random restarts under
+// different seeds derived from `seed` for any threads left over.
+std::vector<SolverOptions> defaultPortfolio(int threads, uint64_t seed,
+											const RoomTables* roomTables);
+
+#endif /* portfolio_h */
@@ -10,19 +10,32 @@
 
 #include <bitset>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include "typedefs.h"
 
-void uglyPrintBoard(const Board& cellValues, const Board& roomIds) {
-	for (const auto& board : {cellValues, roomIds}) {
-		for (const auto& row : board) {
+// Appends `value` to `out`, or a space if it's 0.
+static void appendCell(int value, std::string* out) {
+	if (value) {
+		*out += std::to_string(value);
+	} else {
+		*out += ' ';
+	}
+}
+
+void renderUglyBoard(const Board& cellValues, const Board& roomIds,
+					 std::string* out) {
+	for (const Board* board : {&cellValues, &roomIds}) {
+		for (const auto& row : *board) {
 			for (int c = 0; c < row.size() - 1; c++) {
-				std::cout << row[c] << ' ';
+				*out += std::to_string(row[c]);
+				*out += ' ';
 			}
-			std::cout << row.back() << std::endl;
+			*out += std::to_string(row.back());
+			*out += '\n';
 		}
-		std::cout << std::endl;
+		*out += '\n';
 	}
 }
 
@@ -41,53 +54,49 @@ void uglyPrintBoard(const Board& cellValues, const Board& roomIds) {
 #define NEW "┴"
 #define NSEW "┼"
 
-void prettyPrintBoard(const Board& cellValues, const Board& roomIds) {
+void renderPrettyBoard(const Board& cellValues, const Board& roomIds,
+					   std::string* out) {
 	// Top row of board symbols.
-	std::cout << SE;
+	*out += SE;
 	for (int c = 0; c < cellValues[0].size() - 1; c++) {
-		std::cout << EW;
+		*out += EW;
 		if (roomIds[0][c] != roomIds[0][c + 1]) {
-			std::cout << SEW;
+			*out += SEW;
 		} else {
-			std::cout << EW;
+			*out += EW;
 		}
 	}
-	std::cout << EW << SW << std::endl;
+	*out += EW;
+	*out += SW;
+	*out += '\n';
 
 	// Interior rows of cell values and board symbols.
 	for (int r = 0; r < cellValues.size() - 1; r++) {
 		// Row of cell contents.
-		std::cout << NS;
+		*out += NS;
 		for (int c = 0; c < cellValues[r].size() - 1; c++) {
-			if (cellValues[r][c]) {
-				std::cout << cellValues[r][c];
-			} else {
-				std::cout << ' ';
-			}
+			appendCell(cellValues[r][c], out);
 			if (roomIds[r][c] != roomIds[r][c + 1]) {
-				std::cout << NS;
+				*out += NS;
 			} else {
-				std::cout << ' ';
+				*out += ' ';
 			}
 		}
-		if (cellValues[r].back()) {
-			std::cout << cellValues[r].back();
-		} else {
-			std::cout << ' ';
-		}
-		std::cout << NS << std::endl;
+		appendCell(cellValues[r].back(), out);
+		*out += NS;
+		*out += '\n';
 
 		// Row of board symbols.
 		if (roomIds[r][0] != roomIds[r + 1][0]) {
-			std::cout << NSE;
+			*out += NSE;
 		} else {
-			std::cout << NS;
+			*out += NS;
 		}
 		for (int c = 0; c < cellValues[r].size() - 1; c++) {
 			if (roomIds[r][c] != roomIds[r + 1][c]) {
-				std::cout << EW;
+				*out += EW;
 			} else {
-				std::cout << ' ';
+				*out += ' ';
 			}
 
 			// Space between four cells. Could be any of the special characters.
@@ -107,85 +116,94 @@ void prettyPrintBoard(const Board& cellValues, const Board& roomIds) {
 			}
 			switch (space.to_ulong()) {
 				case 0:
-					std::cout << ' ';
+					*out += ' ';
 					break;
 				case 3:
-					std::cout << NS;
+					*out += NS;
 					break;
 				case 5:
-					std::cout << NE;
+					*out += NE;
 					break;
 				case 6:
-					std::cout << SE;
+					*out += SE;
 					break;
 				case 7:
-					std::cout << NSE;
+					*out += NSE;
 					break;
 				case 9:
-					std::cout << NW;
+					*out += NW;
 					break;
 				case 10:
-					std::cout << SW;
+					*out += SW;
 					break;
 				case 11:
-					std::cout << NSW;
+					*out += NSW;
 					break;
 				case 12:
-					std::cout << EW;
+					*out += EW;
 					break;
 				case 13:
-					std::cout << NEW;
+					*out += NEW;
 					break;
 				case 14:
-					std::cout << SEW;
+					*out += SEW;
 					break;
 				case 15:
-					std::cout << NSEW;
+					*out += NSEW;
 					break;
 				default:
 					std::cerr << "Invalid value for calculating square of 4: "
 							  << space << std::endl;
-					std::cout << "?";
+					*out += '?';
 			}
 		}
 		if (roomIds[r].back() != roomIds[r + 1].back()) {
-			std::cout << EW << NSW;
+			*out += EW;
+			*out += NSW;
 		} else {
-			std::cout << ' ' << NS;
+			*out += ' ';
+			*out += NS;
 		}
-		std::cout << std::endl;
+		*out += '\n';
 	}
 
 	// Last row of cell contents.
-	std::cout << NS;
+	*out += NS;
 	for (int c = 0; c < cellValues.back().size() - 1; c++) {
-		if (cellValues.back()[c]) {
-			std::cout << cellValues.back()[c];
-		} else {
-			std::cout << ' ';
-		}
+		appendCell(cellValues.back()[c], out);
 		if (roomIds.back()[c] != roomIds.back()[c + 1]) {
-			std::cout << NS;
+			*out += NS;
 		} else {
-			std::cout << ' ';
+			*out += ' ';
 		}
 	}
-	if (cellValues.back().back()) {
-		std::cout << cellValues.back().back();
-	} else {
-		std::cout << ' ';
-	}
-	std::cout << NS << std::endl;
+	appendCell(cellValues.back().back(), out);
+	*out += NS;
+	*out += '\n';
 
 	// Last row of board symbols.
-	std::cout << NE;
+	*out += NE;
 	for (int c = 0; c < cellValues.back().size() - 1; c++) {
-		std::cout << EW;
+		*out += EW;
 		if (roomIds.back()[c] != roomIds.back()[c + 1]) {
-			std::cout << NEW;
+			*out += NEW;
 		} else {
-			std::cout << EW;
+			*out += EW;
 		}
 	}
-	std::cout << EW << NW << std::endl;
+	*out += EW;
+	*out += NW;
+	*out += '\n';
+}
+
+void uglyPrintBoard(const Board& cellValues, const Board& roomIds) {
+	std::string out;
+	renderUglyBoard(cellValues, roomIds, &out);
+	std::cout << out << std::flush;
+}
+
+void prettyPrintBoard(const Board& cellValues, const Board& roomIds) {
+	std::string out;
+	renderPrettyBoard(cellValues, roomIds, &out);
+	std::cout << out << std::flush;
 }
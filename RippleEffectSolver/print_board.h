@@ -9,6 +9,8 @@
 #ifndef print_board_h
 #define print_board_h
 
+#include <string>
+
 #include "typedefs.h"
 
 // If your console or font doesn't play nice with the pretty board symbols,
@@ -16,6 +18,24 @@
 // then won't print any sort of room borders.
 // #define SIMPLE_PRINT_BOARD
 
+// The printing routines below each build the whole board in a string and write
+// it to stdout at once. These do the building, appending to `out`, for callers
+// that want the text elsewhere or want to batch several boards together.
+void renderUglyBoard(const Board& cellValues, const Board& roomIds,
+					 std::string* out);
+void renderPrettyBoard(const Board& cellValues, const Board& roomIds,
+					   std::string* out);
+
+// Appends whichever of the above printBoard would use.
+inline void renderBoard(const Board& cellValues, const Board& roomIds,
+						std::string* out) {
+#ifdef SIMPLE_PRINT_BOARD
+	renderUglyBoard(cellValues, roomIds, out);
+#else  /* !SIMPLE_PRINT_BOARD */
+	renderPrettyBoard(cellValues, roomIds, out);
+#endif /* SIMPLE_PRINT_BOARD */
+}
+
 // The ugly, simple version of the printing routine. Doesn't show room borders,
 // just cells' values and their room IDs as two separate boards.
 void uglyPrintBoard(const Board& cellValues, const Board& roomIds);
@@ -30,15 +30,19 @@ std::vector<int> interpretString(const std::string& s) {
 	return v;
 }
 
-bool readCells(size_t* boardWidth, Board* cellValues) {
+bool readCells(std::istream& input, size_t* boardWidth, Board* cellValues,
+			   std::string* error) {
 	std::string s;
 	// Read in the cell values on the board (0 is unset) until an empty line is
 	// reached.
 	do {
-		std::getline(std::cin, s);
+		if (!std::getline(input, s) && cellValues->empty()) {
+			*error = "Board cannot be empty.";
+			return false;
+		}
 		if (s.empty()) {
 			if (cellValues->empty()) {
-				std::cerr << "Board cannot be empty.";
+				// Skip any blank lines before the board.
 				continue;
 			}
 			return true;
@@ -47,31 +51,48 @@ bool readCells(size_t* boardWidth, Board* cellValues) {
 		if (*boardWidth == 0) {
 			*boardWidth = rowValues.size();
 		} else if (*boardWidth != rowValues.size()) {
-			std::cerr << "Inconsistent line size. Terminating." << std::endl;
+			*error = "Inconsistent line size.";
 			return false;
 		}
 		cellValues->push_back(rowValues);
 	} while (true);
 }
 
-bool readRooms(size_t boardWidth, size_t boardHeight, Board* roomIds) {
+bool readRooms(std::istream& input, size_t boardWidth, size_t boardHeight,
+			   Board* roomIds, std::string* error) {
 	std::string s;
 	do {
-		std::getline(std::cin, s);
+		std::getline(input, s);
 		if (s.empty()) {
 			if (roomIds->size() != boardHeight) {
-				std::cerr
-					<< "Failed to specify room IDs for all cells. Terminating."
-					<< std::endl;
+				*error = "Failed to specify room IDs for all cells.";
 				return false;
 			}
 			return true;
 		}
 		const std::vector<int>& cellIds = interpretString(s);
 		if (boardWidth != cellIds.size()) {
-			std::cerr << "Inconsistent line size. Terminating." << std::endl;
+			*error = "Inconsistent line size.";
 			return false;
 		}
 		roomIds->push_back(cellIds);
 	} while (true);
 }
+
+bool readCells(size_t* boardWidth, Board* cellValues) {
+	std::string error;
+	if (!readCells(std::cin, boardWidth, cellValues, &error)) {
+		std::cerr << error << " Terminating." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool readRooms(size_t boardWidth, size_t boardHeight, Board* roomIds) {
+	std::string error;
+	if (!readRooms(std::cin, boardWidth, boardHeight, roomIds, &error)) {
+		std::cerr << error << " Terminating." << std::endl;
+		return false;
+	}
+	return true;
+}
@@ -9,15 +9,26 @@
 #ifndef read_input_h
 #define read_input_h
 
+#include <cstddef>
+#include <istream>
+#include <string>
+
 #include "typedefs.h"
 
-// Reads cell values from stdin. Updates boardWidth as appropriate. Enforces
-// that all rows must be the same width. Returns false if that is not the case,
-// otherwise true.
-bool readCells(size_t* boardWidth, Board* cellValues);
+// Reads cell values from `input`, skipping any blank lines before them. Updates
+// boardWidth as appropriate. Enforces that all rows must be the same width.
+// Returns false, with a description in `error`, if that is not the case or
+// there is no board, otherwise true.
+bool readCells(std::istream& input, size_t* boardWidth, Board* cellValues,
+			   std::string* error);
 
-// Reads cells' room IDs from stdin. Enforces that the values must fit in the
+// Reads cells' room IDs from `input`. Enforces that the values must fit in the
 // same footprint as the board from readCells.
+bool readRooms(std::istream& input, size_t boardWidth, size_t boardHeight,
+			   Board* roomIds, std::string* error);
+
+// Like the above, but reading from stdin and printing any error to stderr.
+bool readCells(size_t* boardWidth, Board* cellValues);
 bool readRooms(size_t boardWidth, size_t boardHeight, Board* roomIds);
 
 #endif /* read_input_h */
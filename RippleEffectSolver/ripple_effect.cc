@@ -0,0 +1,266 @@
+//
+//  ripple_effect.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "ripple_effect.h"
+
+#include <algorithm>
+#include <istream>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "layout_cache.h"
+#include "portfolio.h"
+#include "read_input.h"
+#include "solution_cache.h"
+#include "solve_puzzle.h"
+#include "solver_options.h"
+#include "transposition_table.h"
+#include "typedefs.h"
+#include "validity_checks.h"
+
+// Returns an empty string if the request's boards are both the same rectangle,
+// or else what's wrong with them.
+static std::string checkShape(const Board& cellValues, const Board& roomIds) {
+	if (cellValues.empty() || cellValues[0].empty()) {
+		return "Board cannot be empty.";
+	}
+	if (roomIds.size() != cellValues.size()) {
+		return "Failed to specify room IDs for all cells.";
+	}
+	for (int r = 0; r < cellValues.size(); r++) {
+		if (cellValues[r].size() != cellValues[0].size() ||
+			roomIds[r].size() != cellValues[0].size()) {
+			return "Inconsistent line size.";
+		}
+	}
+	return "";
+}
+
+// Returns an empty string if the clues on a board of the right shape can be
+// searched, or else what's wrong with them. The same checks as
+// validateIncompleteBoard, but taking the rooms' validity from the layout.
+static std::string checkClues(const Board& cellValues, const Layout& layout) {
+	for (int r = 0; r < cellValues.size(); r++) {
+		for (int c = 0; c < cellValues[r].size(); c++) {
+			int value = cellValues[r][c];
+			if (value < 0 ||
+				value > layout.roomMap.at(layout.roomIds[r][c]).size()) {
+				return "Cell values must be between 0 and the size of their "
+					   "room.";
+			}
+		}
+	}
+	bool valid = layout.roomsValid;
+	for (int r = 0; valid && r < cellValues.size(); r++) {
+		for (int c = 0; valid && c < cellValues[r].size(); c++) {
+			int value = cellValues[r][c];
+			valid = !value ||
+					(checkRow({r, c}, value, cellValues) &&
+					 checkColumn({r, c}, value, cellValues) &&
+					 checkRoom({r, c},
+							   layout.roomMap.at(layout.roomIds[r][c]), value,
+							   cellValues));
+		}
+	}
+	return valid ? "" : "Invalid initial board.";
+}
+
+// Answers `request` from what a SolutionCache knows, if that's enough.
+static bool answerFromCache(const SolveRequest& request,
+							const CachedResult& cached, SolveResult* result) {
+	switch (request.mode) {
+		case SolveMode::kSingle:
+			if (!cached.answersSingle()) return false;
+			if (cached.solutionCount != 0) {
+				result->solutions.push_back(cached.solution);
+			}
+			result->solutionCount = result->solutions.size();
+			break;
+		case SolveMode::kAll:
+			if (!cached.answersAll()) return false;
+			if (cached.solutionCount == 1) {
+				result->solutions.push_back(cached.solution);
+			}
+			result->solutionCount = result->solutions.size();
+			break;
+		case SolveMode::kCount:
+			if (!cached.answersCount()) return false;
+			result->solutionCount =
+				request.limit > 0
+					? std::min(cached.solutionCount, request.limit)
+					: cached.solutionCount;
+			break;
+	}
+	result->cached = true;
+	return true;
+}
+
+// What a finished search for `request` found out, to go in a SolutionCache.
+static CachedResult resultToCache(const SolveRequest& request,
+								  const SolveResult& result) {
+	CachedResult cached;
+	// Stopping at the limit leaves the count unknown, and so does stopping at
+	// the first solution.
+	bool exhaustive =
+		request.mode == SolveMode::kSingle
+			? result.solutions.empty()
+			: request.limit <= 0 || result.solutionCount < request.limit;
+	if (exhaustive) {
+		cached.solutionCount = result.solutionCount;
+	}
+	if (!result.solutions.empty()) {
+		cached.solution = result.solutions.front();
+	}
+	return cached;
+}
+
+SolveResult solve(const SolveRequest& request, LayoutCache* layouts,
+				  SolutionCache* solutions) {
+	SolveResult result;
+	const Board& cellValues = request.cellValues;
+	const Board& roomIds = request.roomIds;
+	result.error = checkShape(cellValues, roomIds);
+	if (!result.error.empty()) {
+		return result;
+	}
+	size_t tableBytes =
+		request.transpositionTableEntries > 0
+			? TranspositionTable::bytesFor(request.transpositionTableEntries)
+			: 0;
+	if (request.options.memoryBudget > 0 &&
+		tableBytes >= request.options.memoryBudget) {
+		result.error = "Transposition table is bigger than the memory budget.";
+		return result;
+	}
+	// Only puzzles that were valid were ever stored, so there's no need to
+	// check the clues first.
+	CachedResult cached;
+	if (solutions && solutions->lookup(cellValues, roomIds, &cached) &&
+		answerFromCache(request, cached, &result)) {
+		return result;
+	}
+	std::shared_ptr<const Layout> layout =
+		layouts ? layouts->get(roomIds, request.roomTableMaxCells)
+				: buildLayout(roomIds, request.roomTableMaxCells);
+	result.error = checkClues(cellValues, *layout);
+	if (!result.error.empty()) {
+		return result;
+	}
+	const RoomMap& roomMap = layout->roomMap;
+	std::map<int, int> cellsCompletedInRoom;
+	for (int r = 0; r < cellValues.size(); r++) {
+		for (int c = 0; c < cellValues[r].size(); c++) {
+			if (cellValues[r][c]) cellsCompletedInRoom[roomIds[r][c]]++;
+		}
+	}
+
+	// Everything the search writes to or keeps between nodes belongs to this
+	// call alone.
+	SolverOptions options = request.options;
+	options.stats = &result.stats;
+	options.status = &result.status;
+	if (options.memoryBudget > 0) options.memoryBudget -= tableBytes;
+	// Room tables are only ever read, so the layout's can be shared.
+	options.roomTables = layout->roomTables.get();
+	std::unique_ptr<TranspositionTable> transpositionTable;
+	options.transpositionTable = nullptr;
+	if (request.transpositionTableEntries > 0) {
+		transpositionTable.reset(new TranspositionTable(
+			(int)cellValues.size(), (int)cellValues[0].size(),
+			(int)layout->largestRoom, request.transpositionTableEntries));
+		options.transpositionTable = transpositionTable.get();
+	}
+
+	switch (request.mode) {
+		case SolveMode::kSingle: {
+			std::pair<bool, Board> solvedWithBoard;
+			if (request.portfolioThreads > 0) {
+				auto configurations =
+					defaultPortfolio(request.portfolioThreads, options.seed,
+									 options.roomTables);
+				for (auto& configuration : configurations) {
+					configuration.stats = options.stats;
+					configuration.status = options.status;
+					configuration.cancelled = options.cancelled;
+					configuration.nodeBudget = options.nodeBudget;
+					configuration.deadline = options.deadline;
+				}
+				int winner;
+				solvedWithBoard = findSingleSolutionPortfolio(
+					cellValues, roomIds, roomMap, cellsCompletedInRoom, 0,
+					configurations, &winner);
+				// Every loser was cancelled, so only the winner's status
+				// counts.
+				if (winner != -1) result.status = SolveStatus::kFinished;
+			} else {
+				solvedWithBoard =
+					findSingleSolution(cellValues, roomIds, roomMap,
+									   cellsCompletedInRoom, 0, options);
+			}
+			if (solvedWithBoard.first) {
+				result.solutions.push_back(solvedWithBoard.second);
+			}
+			break;
+		}
+		case SolveMode::kAll:
+			if (request.limit > 0) {
+				// Each solution is visited once, so there's no need for a set
+				// to weed out repeats. Like findAllSolutions, this gives up
+				// once the solutions take more than the memory budget.
+				size_t solutionBytes =
+					sizeof(Board) +
+					cellValues.size() * (sizeof(std::vector<int>) +
+										 cellValues[0].size() * sizeof(int));
+				bool outOfMemory = false;
+				enumerateSolutions(
+					cellValues, roomIds, roomMap, cellsCompletedInRoom, 0,
+					[&](const Board& board) {
+						result.solutions.push_back(board);
+						outOfMemory = options.memoryBudget > 0 &&
+									  result.solutions.size() * solutionBytes >
+										  options.memoryBudget;
+						return !outOfMemory &&
+							   result.solutions.size() < request.limit;
+					},
+					options);
+				if (outOfMemory) result.status = SolveStatus::kOutOfMemory;
+				std::sort(result.solutions.begin(), result.solutions.end());
+			} else {
+				const auto& solvedWithBoards =
+					findAllSolutions(cellValues, roomIds, roomMap,
+									 cellsCompletedInRoom, 0, nullptr, options);
+				result.solutions.assign(solvedWithBoards.second.begin(),
+										solvedWithBoards.second.end());
+			}
+			break;
+		case SolveMode::kCount:
+			result.solutionCount =
+				countSolutions(cellValues, roomIds, roomMap,
+							   cellsCompletedInRoom, 0, request.limit, options);
+			break;
+	}
+	if (request.mode != SolveMode::kCount) {
+		result.solutionCount = result.solutions.size();
+	}
+	if (solutions && result.status == SolveStatus::kFinished) {
+		solutions->store(cellValues, roomIds, resultToCache(request, result));
+	}
+	return result;
+}
+
+bool parsePuzzle(std::istream& input, Board* cellValues, Board* roomIds,
+				 std::string* error) {
+	size_t boardWidth = 0;
+	cellValues->clear();
+	roomIds->clear();
+	return readCells(input, &boardWidth, cellValues, error) &&
+		   readRooms(input, boardWidth, cellValues->size(), roomIds, error);
+}
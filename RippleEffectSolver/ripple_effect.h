@@ -0,0 +1,99 @@
+//
+//  ripple_effect.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef ripple_effect_h
+#define ripple_effect_h
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "solver_options.h"
+#include "typedefs.h"
+
+class LayoutCache;
+class SolutionCache;
+
+// The solver as a library, for programs that embed it rather than running the
+// command-line tools. Everything a call needs goes in its SolveRequest and
+// everything it finds comes back in its SolveResult: nothing is read from
+// stdin, nothing is printed, and no state is shared between calls, so any
+// number of them can run at once on different threads. `make` builds this and
+// everything it relies on into libripple.a.
+
+// What a request asks for.
+enum class SolveMode {
+	// Any one solution.
+	kSingle,
+	// Every solution.
+	kAll,
+	// How many solutions there are, without keeping them.
+	kCount,
+};
+
+struct SolveRequest {
+	// The clues, with 0 for empty cells, and every cell's room ID, in the same
+	// shape. Rooms must be contiguous and each clue between 1 and the size of
+	// its room.
+	Board cellValues;
+	Board roomIds;
+	SolveMode mode = SolveMode::kSingle;
+	// With kAll or kCount, if positive, the search stops once it has found
+	// this many solutions. A limit of 2 makes for a cheap uniqueness check.
+	long long limit = 0;
+	// How to search. `stats` and `status` are ignored, since the result has
+	// its own. So are `roomTables` and `transpositionTable`; the call gets its
+	// own from the sizes below instead. Budgets, `cancelled` and checkpoints
+	// are used as is, so concurrent calls need checkpoint paths of their own.
+	SolverOptions options;
+	// If positive, room tables for every room of up to this many cells.
+	int roomTableMaxCells = 0;
+	// If positive, a transposition table holding up to this many entries. It
+	// comes out of `options.memoryBudget`, if that's positive, and a request
+	// whose table alone wouldn't fit is refused. With kAll, the solutions
+	// found count against the budget too, limit or not.
+	int transpositionTableEntries = 0;
+	// With kSingle, if positive, a default portfolio of this many differently
+	// configured searches races on as many threads instead (see portfolio.h).
+	// Its budgets and `cancelled` come from `options`.
+	int portfolioThreads = 0;
+};
+
+struct SolveResult {
+	// Empty unless the request was malformed, in which case it says what was
+	// wrong and nothing else here is filled in.
+	std::string error;
+	// Anything but kFinished means the search stopped early, so that the
+	// solutions and count are only what was found by then.
+	SolveStatus status = SolveStatus::kFinished;
+	// With kSingle, the solution if one was found. With kAll, every solution
+	// found, in ascending order. Always empty with kCount.
+	std::vector<Board> solutions;
+	long long solutionCount = 0;
+	SolverStats stats;
+	// Whether the answer came from a SolutionCache rather than a search, in
+	// which case `stats` is empty.
+	bool cached = false;
+};
+
+// Answers `request`. Safe to call from several threads at once. If `layouts`
+// is not null, the room map, room validity and room tables come from it rather
+// than being worked out again, which pays off when many requests share rooms.
+// If `solutions` is not null, it's checked before searching, and what a
+// finished search found is stored in it.
+SolveResult solve(const SolveRequest& request,
+				  LayoutCache* layouts = nullptr,
+				  SolutionCache* solutions = nullptr);
+
+// Reads a puzzle from `input` in the same format the command-line tools read
+// from stdin: the clues, a blank line, then the room IDs. Returns false, with a
+// description in `error`, if it isn't well formed.
+bool parsePuzzle(std::istream& input, Board* cellValues, Board* roomIds,
+				 std::string* error);
+
+#endif /* ripple_effect_h */
@@ -0,0 +1,32 @@
+//
+//  room_tables.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "room_tables.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "typedefs.h"
+
+RoomTables::RoomTables(const RoomMap& roomMap, int maxCells) {
+	for (const auto& roomAndCells : roomMap) {
+		int size = (int)roomAndCells.second.size();
+		if (size > maxCells) {
+			continue;
+		}
+		std::vector<std::vector<int>>& table = tables[roomAndCells.first];
+		std::vector<int> filling(size);
+		for (int i = 0; i < size; i++) {
+			filling[i] = i + 1;
+		}
+		do {
+			table.push_back(filling);
+		} while (std::next_permutation(filling.begin(), filling.end()));
+	}
+}
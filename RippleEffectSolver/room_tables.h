@@ -0,0 +1,45 @@
+//
+//  room_tables.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef room_tables_h
+#define room_tables_h
+
+#include <map>
+#include <vector>
+
+#include "typedefs.h"
+
+// Every way of filling in each small room, worked out once when the layout is
+// loaded. A room of n cells must hold 1 through n once each, and since its
+// values are all different, no two of its cells can break the ripple rule with
+// each other. So a room's table is simply every permutation of 1 through n,
+// listed in the order of the room's cells in the RoomMap.
+//
+// The search filters a room's table down to the fillings that agree with the
+// board as it goes, both to rule out values no remaining filling uses and to
+// branch on a whole room at once.
+class RoomTables {
+   public:
+	// Builds tables for every room with at most `maxCells` cells.
+	RoomTables(const RoomMap& roomMap, int maxCells);
+
+	// The fillings of `room`, or null if the room is too big to have a table.
+	const std::vector<std::vector<int>>* fillings(int room) const {
+		const auto& table = tables.find(room);
+		return table == tables.end() ? nullptr : &table->second;
+	}
+
+	const std::map<int, std::vector<std::vector<int>>>& allTables() const {
+		return tables;
+	}
+
+   private:
+	std::map<int, std::vector<std::vector<int>>> tables;
+};
+
+#endif /* room_tables_h */
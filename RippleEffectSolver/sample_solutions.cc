@@ -0,0 +1,209 @@
+//
+//  sample_solutions.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "sample_solutions.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "print_board.h"
+#include "solve_puzzle.h"
+#include "typedefs.h"
+#include "validity_checks.h"
+
+std::vector<WeightedSolution> sampleSolutions(
+	const Board& cellValues, const Board& roomIds, const RoomMap& roomMap,
+	const std::map<int, int>& cellsCompletedInRoom,
+	const SamplingOptions& options, int verbosity, int* attempts) {
+	std::vector<WeightedSolution> samples;
+	std::mt19937 rng(options.seed);
+	const auto start = std::chrono::steady_clock::now();
+	const auto outOfTime = [&options, &start]() {
+		if (options.timeBudgetSeconds <= 0) return false;
+		std::chrono::duration<double> elapsed =
+			std::chrono::steady_clock::now() - start;
+		return elapsed.count() >= options.timeBudgetSeconds;
+	};
+	if (options.sampleCount <= 0 && options.timeBudgetSeconds <= 0) {
+		std::cerr << "Sampling needs a sample count or a time budget."
+				  << std::endl;
+		return samples;
+	}
+
+	// Everything the walks share is computed once up front.
+	Board initial = cellValues;
+	std::map<int, int> initialCompleted = cellsCompletedInRoom;
+	fillKnownCellsInBoard(initial, roomIds, roomMap, initialCompleted,
+						  verbosity);
+
+	int walks = 0, deadEndsInARow = 0;
+	while ((options.sampleCount <= 0 || samples.size() < options.sampleCount) &&
+		   (options.maxDeadEndsInARow <= 0 ||
+			deadEndsInARow < options.maxDeadEndsInARow) &&
+		   !outOfTime()) {
+		walks++;
+		Board walk = initial;
+		std::map<int, int> completed = initialCompleted;
+		double logWeight = 0;
+		bool deadEnd = false;
+		while (!deadEnd && !validateCompleteBoard(walk, roomIds, roomMap)) {
+			// Branch on the first empty cell, just like the exhaustive search.
+			int r = -1, c = -1;
+			for (int row = 0; row < walk.size() && r == -1; row++) {
+				for (int col = 0; col < walk[row].size(); col++) {
+					if (!walk[row][col]) {
+						r = row;
+						c = col;
+						break;
+					}
+				}
+			}
+			if (r == -1) {
+				// Full but invalid. Shouldn't happen, but don't loop on it.
+				deadEnd = true;
+				break;
+			}
+			int room = roomIds[r][c];
+			const CellList& cellsInRoom = roomMap.at(room);
+			std::vector<int> possibleValues;
+			for (int value = 1; value <= cellsInRoom.size(); value++) {
+				if (checkRoom({r, c}, cellsInRoom, value, walk) &&
+					checkRow({r, c}, value, walk) &&
+					checkColumn({r, c}, value, walk)) {
+					possibleValues.push_back(value);
+				}
+			}
+			if (possibleValues.empty()) {
+				deadEnd = true;
+				break;
+			}
+			std::uniform_int_distribution<int> pick(
+				0, (int)possibleValues.size() - 1);
+			int value = possibleValues[pick(rng)];
+			logWeight += std::log((double)possibleValues.size());
+			walk[r][c] = value;
+			completed[room]++;
+			switch (verbosity) {
+				case 2:
+					printBoard(walk, roomIds);
+				case 1:
+					std::cout << "Sampling by filling (" << r + 1 << ", "
+							  << c + 1 << ") with value " << value << " (1 of "
+							  << possibleValues.size() << ")." << std::endl;
+				default:
+					break;
+			}
+			fillKnownCellsInBoard(walk, roomIds, roomMap, completed, verbosity);
+		}
+		if (deadEnd) {
+			deadEndsInARow++;
+		} else {
+			samples.push_back({walk, logWeight});
+			deadEndsInARow = 0;
+		}
+	}
+	switch (verbosity) {
+		case 2:
+		case 1:
+			if (options.maxDeadEndsInARow > 0 &&
+				deadEndsInARow >= options.maxDeadEndsInARow) {
+				std::cout << "Stopped sampling after " << deadEndsInARow
+						  << " dead ends in a row." << std::endl;
+			}
+		default:
+			break;
+	}
+	if (attempts) {
+		*attempts = walks;
+	}
+	return samples;
+}
+
+// Clamps a normal approximation interval to the valid range of a proportion.
+static ProportionEstimate proportionWithInterval(double p,
+												 double effectiveSampleSize,
+												 double zScore) {
+	ProportionEstimate estimate;
+	estimate.estimate = p;
+	double halfWidth = zScore * std::sqrt(p * (1 - p) / effectiveSampleSize);
+	estimate.lower = std::max(0.0, p - halfWidth);
+	estimate.upper = std::min(1.0, p + halfWidth);
+	return estimate;
+}
+
+SolutionEstimate estimateValueFrequencies(
+	const Board& cellValues, const Board& roomIds, const RoomMap& roomMap,
+	const std::map<int, int>& cellsCompletedInRoom,
+	const SamplingOptions& options, int verbosity) {
+	SolutionEstimate result;
+	const auto& samples =
+		sampleSolutions(cellValues, roomIds, roomMap, cellsCompletedInRoom,
+						options, verbosity, &result.attempts);
+	result.samples = (int)samples.size();
+	if (samples.empty()) {
+		return result;
+	}
+
+	// Work relative to the largest weight so nothing overflows; the common
+	// factor cancels out of every ratio below.
+	double maxLogWeight = samples.front().logWeight;
+	for (const auto& sample : samples) {
+		maxLogWeight = std::max(maxLogWeight, sample.logWeight);
+	}
+	std::vector<double> weights;
+	double weightSum = 0, squaredWeightSum = 0;
+	for (const auto& sample : samples) {
+		weights.push_back(std::exp(sample.logWeight - maxLogWeight));
+		weightSum += weights.back();
+		squaredWeightSum += weights.back() * weights.back();
+	}
+	result.effectiveSampleSize = weightSum * weightSum / squaredWeightSum;
+
+	// Each walk (failed ones included, with weight 0) is an unbiased estimate
+	// of the solution count, so their mean is too.
+	double scale = std::exp(maxLogWeight);
+	double mean = weightSum / result.attempts;
+	double variance =
+		std::max(0.0, squaredWeightSum / result.attempts - mean * mean);
+	double halfWidth =
+		options.zScore * std::sqrt(variance / result.attempts);
+	result.solutionCount = mean * scale;
+	result.solutionCountLower = std::max(1.0, (mean - halfWidth) * scale);
+	result.solutionCountUpper = (mean + halfWidth) * scale;
+
+	// Weighted value tallies per cell, then normalized into proportions.
+	std::vector<std::vector<std::map<int, double>>> tallies;
+	for (const auto& row : cellValues) {
+		tallies.emplace_back(row.size());
+	}
+	for (int i = 0; i < samples.size(); i++) {
+		const Board& board = samples[i].board;
+		for (int r = 0; r < board.size(); r++) {
+			for (int c = 0; c < board[r].size(); c++) {
+				tallies[r][c][board[r][c]] += weights[i];
+			}
+		}
+	}
+	for (const auto& row : tallies) {
+		std::vector<std::map<int, ProportionEstimate>> estimateRow(row.size());
+		for (int c = 0; c < row.size(); c++) {
+			for (const auto& valueAndTally : row[c]) {
+				estimateRow[c][valueAndTally.first] = proportionWithInterval(
+					valueAndTally.second / weightSum,
+					result.effectiveSampleSize, options.zScore);
+			}
+		}
+		result.valueFrequencies.push_back(estimateRow);
+	}
+	return result;
+}
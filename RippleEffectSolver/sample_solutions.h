@@ -0,0 +1,96 @@
+//
+//  sample_solutions.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef sample_solutions_h
+#define sample_solutions_h
+
+#include <map>
+#include <vector>
+
+#include "typedefs.h"
+
+// Controls how long sampleSolutions keeps drawing. Sampling stops as soon as
+// any limit is reached; a limit of 0 disables it, but at least one of the
+// first two must be non-zero.
+struct SamplingOptions {
+	// The number of complete solutions to collect.
+	int sampleCount = 1000;
+	// Wall clock budget for sampling, in seconds.
+	double timeBudgetSeconds = 0;
+	// The most walks in a row that may hit a dead end. A board with no
+	// solutions has nothing but dead ends, so without this or a time budget,
+	// sampling it would never stop.
+	int maxDeadEndsInARow = 10000;
+	// Seed for the random walk. The same seed on the same board always yields
+	// the same samples.
+	unsigned int seed = 0;
+	// Width of the reported confidence intervals, as a number of standard
+	// errors. 1.96 gives roughly 95% intervals.
+	double zScore = 1.96;
+};
+
+// A single solution found by a random walk, along with the log of its
+// importance weight: the product of the number of choices available at each
+// branch taken on the way down. Weighting each sample by this value corrects
+// for the walk's bias towards solutions behind narrow branches, so that
+// weighted statistics over the samples estimate statistics over the uniform
+// distribution of solutions. Logs are kept since the product easily overflows
+// a double on large boards.
+struct WeightedSolution {
+	Board board;
+	double logWeight;
+};
+
+// An estimate of a proportion, along with a confidence interval around it.
+struct ProportionEstimate {
+	double estimate = 0;
+	double lower = 0;
+	double upper = 0;
+};
+
+// Everything learned from a round of sampling.
+struct SolutionEstimate {
+	// Random walks attempted, including those that hit a dead end.
+	int attempts = 0;
+	// Random walks that reached a complete solution.
+	int samples = 0;
+	// The number of equally weighted samples the weighted set is worth. Much
+	// smaller than `samples` when the weights are very uneven.
+	double effectiveSampleSize = 0;
+	// Estimated total number of solutions, with a confidence interval.
+	double solutionCount = 0;
+	double solutionCountLower = 0;
+	double solutionCountUpper = 0;
+	// For every cell, the estimated fraction of all solutions that contain
+	// each value in that cell.
+	std::vector<std::vector<std::map<int, ProportionEstimate>>>
+		valueFrequencies;
+};
+
+// Draws random solutions by repeatedly filling in known cells and then
+// branching on the first empty cell with a uniformly random possible value,
+// restarting from the top whenever a walk hits a dead end, until a limit in
+// `options` is reached. Returns only the walks that reached a solution;
+// `attempts` (if not null) receives the total number of walks, which is needed
+// to turn the weights into a solution count.
+std::vector<WeightedSolution> sampleSolutions(
+	const Board& cellValues, const Board& roomIds, const RoomMap& roomMap,
+	const std::map<int, int>& cellsCompletedInRoom,
+	const SamplingOptions& options, int verbosity, int* attempts = nullptr);
+
+// Samples solutions as above and summarizes them as per-cell value frequencies
+// and an estimated solution count. Unlike generateValueFrequencies, memory use
+// depends only on the board size, not on the number of solutions. If no walk
+// reaches a solution, as on a board with none, `samples` is 0 and
+// `valueFrequencies` is empty.
+SolutionEstimate estimateValueFrequencies(
+	const Board& cellValues, const Board& roomIds, const RoomMap& roomMap,
+	const std::map<int, int>& cellsCompletedInRoom,
+	const SamplingOptions& options, int verbosity);
+
+#endif /* sample_solutions_h */
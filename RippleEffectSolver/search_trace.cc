@@ -0,0 +1,195 @@
+//
+//  search_trace.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "search_trace.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+SearchTracer::SearchTracer(size_t maxEventsPerThread)
+	: start(std::chrono::steady_clock::now()),
+	  maxEventsPerThread(maxEventsPerThread) {}
+
+TraceBuffer* SearchTracer::threadBuffer() {
+	std::lock_guard<std::mutex> lock(mutex);
+	TraceBuffer*& buffer = bufferForThread[std::this_thread::get_id()];
+	if (!buffer) {
+		buffers.emplace_back(new TraceBuffer(maxEventsPerThread));
+		buffer = buffers.back().get();
+	}
+	return buffer;
+}
+
+long long SearchTracer::dropped() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	long long dropped = 0;
+	for (const auto& buffer : buffers) {
+		dropped += buffer->dropped;
+	}
+	return dropped;
+}
+
+// How a branch shows up in the exported files, with cells numbered from 1 as
+// in the verbose output.
+static std::string branchName(const TraceEvent& event) {
+	char name[64];
+	if (event.room == -1) {
+		std::snprintf(name, sizeof(name), "(%d, %d) = %d", event.row + 1,
+					  event.column + 1, event.value);
+	} else {
+		std::snprintf(name, sizeof(name), "room (%d, %d) filling %d",
+					  event.row + 1, event.column + 1, event.value);
+	}
+	return name;
+}
+
+// Chrome wants microseconds, but takes fractions of one.
+static double microseconds(int64_t nanoseconds) { return nanoseconds / 1e3; }
+
+bool SearchTracer::writeChromeTrace(const std::string& path) const {
+	FILE* file = std::fopen(path.c_str(), "w");
+	if (!file) {
+		return false;
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	std::fprintf(file, "{\"traceEvents\":[");
+	const char* separator = "\n";
+	for (int thread = 0; thread < buffers.size(); thread++) {
+		std::fprintf(file,
+					 "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+					 "\"tid\":%d,\"args\":{\"name\":\"search %d\"}}",
+					 separator, thread, thread);
+		separator = ",\n";
+		// The depths of the nodes whose spans are open, innermost last. A
+		// node is closed by a backtrack out of it or, if the search gave up
+		// on it without one, the next branch at its depth or above.
+		std::vector<int> open;
+		auto closeFrom = [&](int depth, int64_t time) {
+			while (!open.empty() && open.back() >= depth) {
+				std::fprintf(file,
+							 ",\n{\"ph\":\"E\",\"pid\":1,\"tid\":%d,"
+							 "\"ts\":%.3f}",
+							 thread, microseconds(time));
+				open.pop_back();
+			}
+		};
+		int64_t last = 0;
+		for (const TraceEvent& event : buffers[thread]->events) {
+			switch (event.kind) {
+				case TraceEventKind::kBranch:
+					closeFrom(event.depth, event.time);
+					std::fprintf(file,
+								 ",\n{\"name\":\"%s\",\"ph\":\"B\",\"pid\":1,"
+								 "\"tid\":%d,\"ts\":%.3f,"
+								 "\"args\":{\"depth\":%d}}",
+								 branchName(event).c_str(), thread,
+								 microseconds(event.time), event.depth);
+					open.push_back(event.depth);
+					break;
+				case TraceEventKind::kPropagate:
+					std::fprintf(file,
+								 ",\n{\"name\":\"fill in known cells\","
+								 "\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+								 "\"ts\":%.3f,\"dur\":%.3f,"
+								 "\"args\":{\"depth\":%d,\"cells\":%d}}",
+								 thread, microseconds(event.time),
+								 microseconds(event.duration), event.depth,
+								 event.value);
+					break;
+				case TraceEventKind::kBacktrack:
+					closeFrom(event.depth, event.time);
+					break;
+				case TraceEventKind::kSolution:
+					std::fprintf(file,
+								 ",\n{\"name\":\"solution\",\"ph\":\"i\","
+								 "\"s\":\"t\",\"pid\":1,\"tid\":%d,"
+								 "\"ts\":%.3f,\"args\":{\"depth\":%d}}",
+								 thread, microseconds(event.time),
+								 event.depth);
+					break;
+			}
+			last = std::max(last, event.time + event.duration);
+		}
+		closeFrom(0, last);
+	}
+	std::fprintf(file, "\n]}\n");
+	return std::fclose(file) == 0;
+}
+
+bool SearchTracer::writeFoldedStacks(const std::string& path) const {
+	// Nanoseconds spent directly in each path of branches, not counting the
+	// nodes below it, keyed by the path as a folded stack: semicolon-separated
+	// branches from the root.
+	std::map<std::string, int64_t> selfTimes;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (int thread = 0; thread < buffers.size(); thread++) {
+			struct Span {
+				int depth;
+				int64_t start, children;
+				size_t stackLength;
+			};
+			std::string stack = "search " + std::to_string(thread);
+			std::vector<Span> open;
+			auto closeFrom = [&](int depth, int64_t time) {
+				while (!open.empty() && open.back().depth >= depth) {
+					const Span& span = open.back();
+					int64_t total = time - span.start;
+					selfTimes[stack] += total - span.children;
+					stack.resize(span.stackLength);
+					open.pop_back();
+					if (!open.empty()) open.back().children += total;
+				}
+			};
+			int64_t last = 0;
+			for (const TraceEvent& event : buffers[thread]->events) {
+				switch (event.kind) {
+					case TraceEventKind::kBranch:
+						closeFrom(event.depth, event.time);
+						open.push_back({event.depth, event.time, 0,
+										stack.size()});
+						stack += ';';
+						stack += branchName(event);
+						break;
+					case TraceEventKind::kPropagate:
+						selfTimes[stack + ";fill in known cells"] +=
+							event.duration;
+						if (!open.empty()) {
+							open.back().children += event.duration;
+						}
+						break;
+					case TraceEventKind::kBacktrack:
+						closeFrom(event.depth, event.time);
+						break;
+					case TraceEventKind::kSolution:
+						break;
+				}
+				last = std::max(last, event.time + event.duration);
+			}
+			closeFrom(0, last);
+		}
+	}
+	FILE* file = std::fopen(path.c_str(), "w");
+	if (!file) {
+		return false;
+	}
+	for (const auto& stackAndTime : selfTimes) {
+		if (stackAndTime.second > 0) {
+			std::fprintf(file, "%s %" PRId64 "\n", stackAndTime.first.c_str(),
+						 stackAndTime.second);
+		}
+	}
+	return std::fclose(file) == 0;
+}
@@ -0,0 +1,114 @@
+//
+//  search_trace.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef search_trace_h
+#define search_trace_h
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// What a TraceEvent records.
+enum class TraceEventKind : uint8_t {
+	// The search branched into a child node at `depth`, by filling `row`,
+	// `column` with `value`, or when branching on rooms, by filling `room`
+	// (whose first cell is `row`, `column`) with filling number `value`.
+	kBranch,
+	// Filling in known cells at `depth` took `duration` nanoseconds and
+	// filled in `value` cells.
+	kPropagate,
+	// The search left the node at `depth`, having visited everything below
+	// it or given up on it.
+	kBacktrack,
+	// The node at `depth` is solved.
+	kSolution,
+};
+
+struct TraceEvent {
+	// Nanoseconds since the tracer was created.
+	int64_t time;
+	int64_t duration;
+	TraceEventKind kind;
+	int depth;
+	int row, column, room, value;
+};
+
+// The events recorded by one thread. Only that thread ever writes to it, so
+// recording takes no locks.
+class TraceBuffer {
+   public:
+	explicit TraceBuffer(size_t capacity) : capacity(capacity) {}
+
+	// Appends `event`, or counts it as dropped if the buffer is full.
+	void record(const TraceEvent& event) {
+		if (events.size() < capacity) {
+			events.push_back(event);
+		} else {
+			dropped++;
+		}
+	}
+
+	std::vector<TraceEvent> events;
+	long long dropped = 0;
+
+   private:
+	size_t capacity;
+};
+
+// Records what the backtracking searches do, for working out where a slow
+// search spends its time. Set SolverOptions::tracer to one to record branches,
+// batches of filling in known cells and backtracks, with timestamps and depths.
+// Searches without a tracer only pay for a null check at each of those points.
+// One tracer can be shared by any number of searches and threads, each thread
+// getting a buffer of its own. Searches with the learning engine aren't
+// traced.
+class SearchTracer {
+   public:
+	// Keeps at most `maxEventsPerThread` events from each thread, dropping the
+	// rest.
+	explicit SearchTracer(size_t maxEventsPerThread = 1 << 22);
+
+	// The calling thread's buffer, added the first time it asks. Searches ask
+	// once when they start and then record into it without locking.
+	TraceBuffer* threadBuffer();
+
+	// Nanoseconds since the tracer was created.
+	int64_t now() const {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				   std::chrono::steady_clock::now() - start)
+			.count();
+	}
+
+	// Events dropped because a buffer was full, across every thread.
+	long long dropped() const;
+
+	// Writes everything recorded to `path`, as Chrome trace-event JSON (for
+	// chrome://tracing or Perfetto) with one track per thread and one nested
+	// span per search node, or as folded stacks (for flamegraph.pl or
+	// speedscope) giving the nanoseconds spent at each path of branches from
+	// the root. Returns false if the file couldn't be written. Only call
+	// these once every traced search has finished.
+	bool writeChromeTrace(const std::string& path) const;
+	bool writeFoldedStacks(const std::string& path) const;
+
+   private:
+	std::chrono::steady_clock::time_point start;
+	size_t maxEventsPerThread;
+	mutable std::mutex mutex;
+	// In the order the threads first asked, which numbers their tracks.
+	std::vector<std::unique_ptr<TraceBuffer>> buffers;
+	std::map<std::thread::id, TraceBuffer*> bufferForThread;
+};
+
+#endif /* search_trace_h */
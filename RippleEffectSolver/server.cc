@@ -0,0 +1,462 @@
+//
+//  server.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "server.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "layout_cache.h"
+#include "solution_cache.h"
+#include "ripple_effect.h"
+#include "solver_options.h"
+#include "typedefs.h"
+
+// The deadline `milliseconds` from now, or none if that isn't positive.
+static std::chrono::steady_clock::time_point
+deadlineIn(long long milliseconds) {
+	if (milliseconds <= 0) return std::chrono::steady_clock::time_point::max();
+	return std::chrono::steady_clock::now() +
+		   std::chrono::milliseconds(std::min(milliseconds, 1LL << 40));
+}
+
+// `megabytes` as a memory budget, or none if that isn't positive.
+static size_t memoryBudget(long long megabytes) {
+	return megabytes > 0 ? (size_t)std::min(megabytes, 1LL << 20) << 20 : 0;
+}
+
+// Reads the integer at `*cursor`, skipping spaces before it, and moves past it.
+// Returns false if there isn't one, or it doesn't end at a space or the end of
+// the line.
+static bool readNumber(const char** cursor, long long* number) {
+	char* end;
+	errno = 0;
+	*number = std::strtoll(*cursor, &end, 10);
+	if (end == *cursor || errno == ERANGE ||
+		(*end != '\0' && *end != ' ' && *end != '\t' && *end != '\r')) {
+		return false;
+	}
+	*cursor = end;
+	return true;
+}
+
+// Reads the word at `*cursor`, skipping spaces before it, and moves past it.
+// Returns false at the end of the line.
+static bool readWord(const char** cursor, std::string* word) {
+	const char* start = *cursor;
+	while (*start == ' ' || *start == '\t' || *start == '\r') start++;
+	const char* end = start;
+	while (*end != '\0' && *end != ' ' && *end != '\t' && *end != '\r') end++;
+	word->assign(start, end);
+	*cursor = end;
+	return end != start;
+}
+
+static bool readBoard(const char** cursor, long long height, long long width,
+					  Board* board) {
+	board->assign(height, std::vector<int>(width));
+	for (auto& row : *board) {
+		for (int& cell : row) {
+			long long value;
+			if (!readNumber(cursor, &value) || value < INT_MIN ||
+				value > INT_MAX) {
+				return false;
+			}
+			cell = (int)value;
+		}
+	}
+	return true;
+}
+
+bool parseRequestLine(const char* line, const ServerOptions& options,
+					  SolveRequest* request, std::string* error) {
+	const char* cursor = line;
+	std::string word;
+	if (!readWord(&cursor, &word)) {
+		*error = "Empty request.";
+		return false;
+	}
+	if (word == "single") {
+		request->mode = SolveMode::kSingle;
+	} else if (word == "all") {
+		request->mode = SolveMode::kAll;
+	} else if (word == "count") {
+		request->mode = SolveMode::kCount;
+	} else {
+		*error = "Unknown mode " + word + ".";
+		return false;
+	}
+	long long height, width;
+	if (!readNumber(&cursor, &height) || !readNumber(&cursor, &width) ||
+		height <= 0 || width <= 0) {
+		*error = "Expected a positive height and width.";
+		return false;
+	}
+	if (height * width > options.maxCells || height > options.maxCells ||
+		width > options.maxCells) {
+		*error = "Board is too big.";
+		return false;
+	}
+	if (!readBoard(&cursor, height, width, &request->cellValues) ||
+		!readBoard(&cursor, height, width, &request->roomIds)) {
+		*error = "Expected height * width clues and room IDs.";
+		return false;
+	}
+	SolverOptions& solverOptions = request->options;
+	request->limit =
+		request->mode == SolveMode::kAll ? std::max(options.defaultLimit, 0LL)
+										 : 0;
+	solverOptions.deadline = deadlineIn(options.defaultMilliseconds);
+	solverOptions.memoryBudget = memoryBudget(options.defaultMegabytes);
+	while (readWord(&cursor, &word)) {
+		size_t equals = word.find('=');
+		long long value;
+		const char* number = word.c_str() + equals + 1;
+		if (equals == std::string::npos || !readNumber(&number, &value) ||
+			*number != '\0') {
+			*error = "Expected <option>=<integer>, not " + word + ".";
+			return false;
+		}
+		std::string name = word.substr(0, equals);
+		if (name == "limit") {
+			request->limit = value;
+		} else if (name == "nodes") {
+			solverOptions.nodeBudget = value;
+		} else if (name == "ms") {
+			solverOptions.deadline = deadlineIn(value);
+		} else if (name == "mb") {
+			solverOptions.memoryBudget = memoryBudget(value);
+		} else if (name == "tables") {
+			request->roomTableMaxCells = (int)std::min(value, 8LL);
+		} else if (name == "tt") {
+			request->transpositionTableEntries =
+				(int)std::min(value, 1LL << 24);
+		} else if (name == "portfolio") {
+			request->portfolioThreads = (int)std::min(value, 64LL);
+		} else if (name == "engine") {
+			solverOptions.engine = value ? SearchEngine::kLearning
+										 : SearchEngine::kBacktracking;
+		} else if (name == "lines") {
+			solverOptions.lineRules = value != 0;
+		} else if (name == "matching") {
+			solverOptions.roomMatching = value != 0;
+		} else if (name == "branchrooms") {
+			solverOptions.roomBranching = value != 0;
+		} else if (name == "probe") {
+			solverOptions.probeBudget = value;
+		} else if (name == "order") {
+			if (value < 0 || value > (int)ValueOrder::kRandom) {
+				*error = "Unknown value order.";
+				return false;
+			}
+			solverOptions.valueOrder = static_cast<ValueOrder>(value);
+		} else if (name == "seed") {
+			solverOptions.seed = (uint64_t)value;
+		} else {
+			*error = "Unknown option " + name + ".";
+			return false;
+		}
+	}
+	return true;
+}
+
+static const char* statusWord(SolveStatus status) {
+	switch (status) {
+		case SolveStatus::kFinished:
+			return "finished";
+		case SolveStatus::kOutOfNodes:
+			return "nodes";
+		case SolveStatus::kOutOfTime:
+			return "time";
+		case SolveStatus::kOutOfMemory:
+			return "memory";
+		case SolveStatus::kCancelled:
+			return "cancelled";
+	}
+	return "unknown";
+}
+
+std::string formatResponseLine(const SolveResult& result) {
+	if (!result.error.empty()) {
+		return "error " + result.error;
+	}
+	std::string line = "ok ";
+	line += statusWord(result.status);
+	line += ' ';
+	line += std::to_string(result.solutionCount);
+	line += ' ';
+	line += std::to_string(result.solutions.size());
+	for (const auto& board : result.solutions) {
+		for (const auto& row : board) {
+			for (int value : row) {
+				line += ' ';
+				line += std::to_string(value);
+			}
+		}
+	}
+	return line;
+}
+
+// A request waiting for, or being answered by, a worker.
+struct Job {
+	SolveRequest request;
+	std::promise<std::string> response;
+};
+
+// The requests from every connection, waiting for a worker.
+class JobQueue {
+   public:
+	JobQueue(int workers, int maxBatch)
+		: workers(workers), maxBatch(std::max(maxBatch, 1)) {}
+
+	void push(Job* job) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			jobs.push_back(job);
+		}
+		available.notify_one();
+	}
+
+	// Waits for a job, then takes it and up to `maxBatch` - 1 more into
+	// `batch`, but no more than an even share of the queue between workers,
+	// so that a burst of requests is spread over the pool rather than left to
+	// the first worker to wake.
+	void popBatch(std::vector<Job*>* batch) {
+		std::unique_lock<std::mutex> lock(mutex);
+		available.wait(lock, [this]() { return !jobs.empty(); });
+		size_t share = (jobs.size() + workers - 1) / workers;
+		size_t count = std::min(share, (size_t)maxBatch);
+		batch->assign(jobs.begin(), jobs.begin() + count);
+		jobs.erase(jobs.begin(), jobs.begin() + count);
+	}
+
+   private:
+	int workers, maxBatch;
+	std::mutex mutex;
+	std::condition_variable available;
+	std::deque<Job*> jobs;
+};
+
+static void work(JobQueue* queue, LayoutCache* layouts,
+				 SolutionCache* solutions) {
+	std::vector<Job*> batch;
+	while (true) {
+		queue->popBatch(&batch);
+		// Requests sharing a layout run back to back, so that its cache entry
+		// is still hot for all of them.
+		std::stable_sort(batch.begin(), batch.end(),
+						 [](const Job* a, const Job* b) {
+							 return a->request.roomIds < b->request.roomIds;
+						 });
+		for (Job* job : batch) {
+			job->response.set_value(
+				formatResponseLine(solve(job->request, layouts, solutions)));
+		}
+	}
+}
+
+static bool writeAll(int fd, const std::string& data) {
+	size_t written = 0;
+	while (written < data.size()) {
+		ssize_t count =
+			write(fd, data.data() + written, data.size() - written);
+		if (count < 0 && errno == EINTR) continue;
+		if (count <= 0) return false;
+		written += count;
+	}
+	return true;
+}
+
+static void serveConnection(int fd, JobQueue* queue,
+							const ServerOptions* options) {
+	// Room for the longest request allowed, with every number at full length.
+	size_t maxLine = (size_t)options->maxCells * 2 * 12 + 4096;
+	std::string buffer;
+	std::vector<char> chunk(1 << 16);
+	// Responses still to write, in order. Each is either a job being worked on
+	// or, if that's null, an error found while parsing.
+	struct Pending {
+		std::unique_ptr<Job> job;
+		std::future<std::string> response;
+		std::string error;
+	};
+	std::vector<Pending> pending;
+	while (true) {
+		ssize_t count = read(fd, chunk.data(), chunk.size());
+		if (count < 0 && errno == EINTR) continue;
+		if (count <= 0) break;
+		buffer.append(chunk.data(), count);
+		// Every complete line goes on the queue before waiting for any of
+		// them, so that pipelined requests are worked on side by side.
+		size_t start = 0, end;
+		while ((end = buffer.find('\n', start)) != std::string::npos) {
+			buffer[end] = '\0';
+			const char* line = buffer.c_str() + start;
+			start = end + 1;
+			if (line[0] == '\0' || (line[0] == '\r' && line[1] == '\0')) {
+				continue;
+			}
+			Pending response;
+			response.job.reset(new Job());
+			if (parseRequestLine(line, *options, &response.job->request,
+								 &response.error)) {
+				response.response = response.job->response.get_future();
+				queue->push(response.job.get());
+			} else {
+				response.job.reset();
+			}
+			pending.push_back(std::move(response));
+		}
+		buffer.erase(0, start);
+		bool tooLong = buffer.size() > maxLine;
+		if (tooLong) {
+			Pending response;
+			response.error = "Request is too long.";
+			pending.push_back(std::move(response));
+		}
+		std::string out;
+		for (auto& response : pending) {
+			out += response.job ? response.response.get()
+								: "error " + response.error;
+			out += '\n';
+		}
+		pending.clear();
+		if (!writeAll(fd, out) || tooLong) break;
+	}
+	close(fd);
+}
+
+// Binds and listens on the socket `options` asks for. Returns the listening
+// socket, or -1 with a message on stderr.
+static int listenOn(const ServerOptions& options) {
+	int fd;
+	if (options.tcpPort > 0) {
+		fd = socket(AF_INET, SOCK_STREAM, 0);
+		int reuse = 1;
+		if (fd >= 0) {
+			setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+		}
+		sockaddr_in address;
+		std::memset(&address, 0, sizeof(address));
+		address.sin_family = AF_INET;
+		address.sin_port = htons((uint16_t)options.tcpPort);
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		if (fd < 0 ||
+			bind(fd, (const sockaddr*)&address, sizeof(address)) != 0) {
+			std::cerr << "Failed to bind to port " << options.tcpPort << ": "
+					  << std::strerror(errno) << std::endl;
+			if (fd >= 0) close(fd);
+			return -1;
+		}
+	} else {
+		sockaddr_un address;
+		std::memset(&address, 0, sizeof(address));
+		address.sun_family = AF_UNIX;
+		if (options.socketPath.empty() ||
+			options.socketPath.size() >= sizeof(address.sun_path)) {
+			std::cerr << "Invalid socket path " << options.socketPath << "."
+					  << std::endl;
+			return -1;
+		}
+		std::strcpy(address.sun_path, options.socketPath.c_str());
+		// A socket left over from an earlier run would make bind fail.
+		unlink(options.socketPath.c_str());
+		fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0 ||
+			bind(fd, (const sockaddr*)&address, sizeof(address)) != 0) {
+			std::cerr << "Failed to bind to " << options.socketPath << ": "
+					  << std::strerror(errno) << std::endl;
+			if (fd >= 0) close(fd);
+			return -1;
+		}
+	}
+	if (listen(fd, SOMAXCONN) != 0) {
+		std::cerr << "Failed to listen: " << std::strerror(errno) << std::endl;
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+int runServer(const ServerOptions& options) {
+	int listener = listenOn(options);
+	if (listener < 0) {
+		return 1;
+	}
+	// A client hanging up early should only end its own connection.
+	std::signal(SIGPIPE, SIG_IGN);
+
+	int workers = options.workers > 0
+					  ? options.workers
+					  : std::max((int)std::thread::hardware_concurrency(), 1);
+	// These live as long as the process, since the threads using them never
+	// finish.
+	JobQueue* queue = new JobQueue(workers, options.maxBatch);
+	LayoutCache* layouts = new LayoutCache(options.layoutCacheEntries);
+	SolutionCache* solutions = nullptr;
+	if (!options.solutionCachePath.empty()) {
+		solutions = new SolutionCache(options.solutionCachePath,
+									  options.solutionCacheSlots);
+		if (!solutions->isOpen()) {
+			std::cerr << "Failed to open the solution cache at "
+					  << options.solutionCachePath << "." << std::endl;
+			return 1;
+		}
+	}
+	for (int i = 0; i < workers; i++) {
+		std::thread(work, queue, layouts, solutions).detach();
+	}
+	switch (options.verbosity) {
+		case 2:
+		case 1:
+			std::cerr << "Listening with " << workers << " workers."
+					  << std::endl;
+		default:
+			break;
+	}
+	while (true) {
+		int fd = accept(listener, nullptr, nullptr);
+		if (fd < 0) {
+			if (errno != EINTR && options.verbosity > 0) {
+				std::cerr << "Failed to accept a connection: "
+						  << std::strerror(errno) << std::endl;
+			}
+			continue;
+		}
+		if (options.tcpPort > 0) {
+			// Responses are written whole, so there's nothing to gain from
+			// waiting to coalesce them.
+			int noDelay = 1;
+			setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay,
+					   sizeof(noDelay));
+		}
+		std::thread(serveConnection, fd, queue, &options).detach();
+	}
+}
@@ -0,0 +1,97 @@
+//
+//  server.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef server_h
+#define server_h
+
+#include <cstddef>
+#include <string>
+
+#include "ripple_effect.h"
+
+// A long-running solver that answers requests over a socket, so that a client
+// solving many puzzles pays for process startup and layout setup only once.
+//
+// Requests and responses are single lines of space-separated words, so that
+// both ends can parse them without much more than strtol. A request is
+//     <mode> <height> <width> <clues...> <room IDs...> [<option>=<value>...]
+// where `mode` is single, all or count, and the clues and room IDs are
+// `height` * `width` integers each, row by row. The options are:
+//     limit       SolveRequest::limit
+//     nodes       the node budget
+//     ms          a time limit in milliseconds, counted from receipt, or 0
+//                 for none
+//     mb          SolverOptions::memoryBudget in megabytes, or 0 for none;
+//                 a transposition table counts against it
+//     tables      SolveRequest::roomTableMaxCells
+//     tt          SolveRequest::transpositionTableEntries
+//     portfolio   SolveRequest::portfolioThreads
+//     engine      0 = backtracking, 1 = learning
+//     lines       line rules (0 or 1)
+//     matching    room matching (0 or 1)
+//     branchrooms room branching (0 or 1)
+//     probe       the probe budget
+//     order       value order, numbered as in solver_main.cc
+//     seed        the random seed
+// The response is either
+//     ok <status> <count> <boards> <cells...>
+// where `status` is finished, nodes, time, memory or cancelled, `count` is
+// the solution count, and `boards` solutions follow, `height` * `width` values
+// each, or
+//     error <message>
+// Requests may be pipelined; responses come back in the same order. A request
+// that doesn't set `limit` (with all), `ms` or `mb` gets the server's default,
+// so that no one request can hold a worker or its memory indefinitely.
+//
+// Each connection gets a thread that reads requests and writes responses.
+// Requests from every connection go on one queue, which a pool of workers
+// takes from in batches, sorted so that requests sharing a layout run back to
+// back. Layouts are kept in a LayoutCache, and, if there's a file for it,
+// answers in a SolutionCache.
+
+struct ServerOptions {
+	// Where to listen. If `tcpPort` is positive, on that port on 127.0.0.1;
+	// otherwise on a Unix domain socket at `socketPath`, replacing any stale
+	// socket file there.
+	std::string socketPath = "/tmp/ripple.sock";
+	int tcpPort = 0;
+	// Worker threads, or 0 for one per hardware thread.
+	int workers = 0;
+	// The most requests a worker takes off the queue at once.
+	int maxBatch = 16;
+	// Layouts kept in the cache.
+	size_t layoutCacheEntries = 64;
+	// If not empty, the SolutionCache file to answer repeated requests from,
+	// and the slots it's created with if it doesn't exist yet.
+	std::string solutionCachePath;
+	size_t solutionCacheSlots = 1 << 16;
+	// Requests bigger than this many cells are refused.
+	long long maxCells = 1 << 16;
+	// What requests that don't say otherwise get, or 0 for none: the most
+	// solutions an all request lists, its time limit in milliseconds, and its
+	// memory budget in megabytes.
+	long long defaultLimit = 1000;
+	long long defaultMilliseconds = 60000;
+	long long defaultMegabytes = 256;
+	// 0 = silent, 1 = log connections and setup failures to stderr.
+	int verbosity = 0;
+};
+
+// Parses one request line into `request`. Returns false, with a description in
+// `error`, if it isn't well formed.
+bool parseRequestLine(const char* line, const ServerOptions& options,
+					  SolveRequest* request, std::string* error);
+
+// Formats `result` as a response line, without the newline.
+std::string formatResponseLine(const SolveResult& result);
+
+// Listens and answers requests until the process is killed. Only returns, with
+// a message on stderr, if it couldn't start listening.
+int runServer(const ServerOptions& options);
+
+#endif /* server_h */
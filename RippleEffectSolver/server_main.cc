@@ -0,0 +1,64 @@
+//
+//  server_main.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include <string>
+
+#include "server.h"
+
+// Socket settings. If tcpPort is positive, listen on that port on localhost;
+// otherwise, listen on a Unix domain socket at socketPath. See server.h for the
+// protocol.
+std::string socketPath = "/tmp/ripple.sock";
+int tcpPort = 0;
+
+// Worker settings. 0 = one worker thread per hardware thread, n > 0 = n worker
+// threads. Each worker takes up to maxBatch queued requests at a time.
+int workerThreads = 0;
+int maxBatch = 16;
+
+// Layout cache settings. The room map, room validity and room tables of up to
+// this many recently used room layouts are kept, so that requests reusing a
+// layout with different clues skip working them out.
+int layoutCacheEntries = 64;
+
+// Solution cache settings. Empty = solve every request, a file name = keep the
+// answers of finished searches in that file, created with room for
+// solutionCacheSlots puzzles if it doesn't exist, and answer requests for the
+// same puzzle from it without searching. The file can be shared with other
+// servers and with the solver.
+std::string solutionCachePath = "";
+int solutionCacheSlots = 1 << 16;
+
+// Request settings. What a request gets unless it says otherwise: an all
+// request lists at most defaultLimit solutions, every search gives up after
+// defaultMilliseconds milliseconds, and an all request gives up once its
+// solutions take about defaultMegabytes megabytes, less any transposition
+// table, which can't be bigger than that. 0 = no limit.
+long long defaultLimit = 1000;
+long long defaultMilliseconds = 60000;
+long long defaultMegabytes = 256;
+
+// Verbosity settings. 0 = silent, 1 = log startup and connection failures to
+// stderr.
+int verbosity = 1;
+
+int main(void) {
+	ServerOptions options;
+	options.socketPath = socketPath;
+	options.tcpPort = tcpPort;
+	options.workers = workerThreads;
+	options.maxBatch = maxBatch;
+	options.layoutCacheEntries = layoutCacheEntries;
+	options.solutionCachePath = solutionCachePath;
+	options.solutionCacheSlots = solutionCacheSlots;
+	options.defaultLimit = defaultLimit;
+	options.defaultMilliseconds = defaultMilliseconds;
+	options.defaultMegabytes = defaultMegabytes;
+	options.verbosity = verbosity;
+	return runServer(options);
+}
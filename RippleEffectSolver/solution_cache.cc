@@ -0,0 +1,251 @@
+//
+//  solution_cache.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "solution_cache.h"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "canonical_form.h"
+#include "typedefs.h"
+
+static const char kMagic[8] = {'R', 'I', 'P', 'P', 'L', 'E', 'S', 'C'};
+static const uint32_t kVersion = 2;
+// Slots looked at for each fingerprint, starting from its home slot.
+static const int kProbes = 8;
+
+// The start of the file. The slots follow it.
+struct FileHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t slotSize;
+	uint64_t slotCount;
+	uint8_t padding[40];
+};
+
+struct SolutionCache::Slot {
+	// Odd while the slot is being written.
+	uint64_t sequence;
+	// The fingerprint of the puzzle's canonical form, or both zero if the
+	// slot is empty.
+	uint64_t high, low;
+	int64_t solutionCount;
+	// The canonical form's dimensions.
+	uint16_t height, width;
+	// Whether `cells` holds a solution to the canonical form, packed 4 bits
+	// per cell, row by row.
+	uint32_t hasSolution;
+	uint8_t cells[kMaxCells / 2];
+};
+
+// The fingerprint a puzzle is kept under, given its canonical form. An
+// all-zero one marks an empty slot, so it's moved aside.
+static Fingerprint keyOf(const CanonicalPuzzle& canonical) {
+	Fingerprint fingerprint =
+		fingerprintPuzzle(canonical.cellValues, canonical.roomIds);
+	if (!fingerprint.high && !fingerprint.low) fingerprint.low = 1;
+	return fingerprint;
+}
+
+// Whether a board of these dimensions fits in a slot.
+static bool fitsInSlot(const Board& cellValues) {
+	return !cellValues.empty() &&
+		   cellValues.size() * cellValues[0].size() <= SolutionCache::kMaxCells;
+}
+
+SolutionCache::SolutionCache(const std::string& path, size_t capacity) {
+	fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	writable = fd != -1;
+	if (fd == -1) fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1) return;
+	struct stat info;
+	if (writable && capacity > 0) {
+		// Whoever takes the lock first on a new file sets it up.
+		flock(fd, LOCK_EX);
+		if (fstat(fd, &info) == 0 && info.st_size == 0) {
+			FileHeader header;
+			std::memset(&header, 0, sizeof(header));
+			std::memcpy(header.magic, kMagic, sizeof(kMagic));
+			header.version = kVersion;
+			header.slotSize = sizeof(Slot);
+			header.slotCount = capacity;
+			if (ftruncate(fd, sizeof(header) + capacity * sizeof(Slot)) ||
+				pwrite(fd, &header, sizeof(header), 0) != sizeof(header)) {
+				ftruncate(fd, 0);
+			}
+		}
+		flock(fd, LOCK_UN);
+	}
+	if (fstat(fd, &info) != 0 || info.st_size < sizeof(FileHeader)) return;
+	mapping = mmap(nullptr, info.st_size,
+				   writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED,
+				   fd, 0);
+	if (mapping == MAP_FAILED) {
+		mapping = nullptr;
+		return;
+	}
+	mappingSize = info.st_size;
+	const FileHeader* header = static_cast<const FileHeader*>(mapping);
+	size_t slotsInFile = (mappingSize - sizeof(FileHeader)) / sizeof(Slot);
+	if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) ||
+		header->version != kVersion || header->slotSize != sizeof(Slot) ||
+		header->slotCount == 0 || header->slotCount > slotsInFile) {
+		return;
+	}
+	slotCount = header->slotCount;
+	slots = reinterpret_cast<Slot*>(static_cast<char*>(mapping) +
+									sizeof(FileHeader));
+}
+
+SolutionCache::~SolutionCache() {
+	if (mapping) munmap(mapping, mappingSize);
+	if (fd != -1) close(fd);
+}
+
+bool SolutionCache::find(const Fingerprint& fingerprint, Slot* copy) const {
+	size_t home = fingerprint.low % slotCount;
+	for (int probe = 0; probe < kProbes; probe++) {
+		const Slot& slot = slots[(home + probe) % slotCount];
+		uint64_t sequence = __atomic_load_n(&slot.sequence, __ATOMIC_ACQUIRE);
+		if (sequence & 1) {
+			// Being written. Whatever it held or will hold, missing it is
+			// safe.
+			continue;
+		}
+		std::memcpy(copy, &slot, sizeof(Slot));
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (__atomic_load_n(&slot.sequence, __ATOMIC_RELAXED) != sequence) {
+			continue;
+		}
+		if (copy->high == fingerprint.high && copy->low == fingerprint.low) {
+			return true;
+		}
+		if (!copy->high && !copy->low) {
+			// Slots are never emptied, so nothing is kept further on.
+			return false;
+		}
+	}
+	return false;
+}
+
+bool SolutionCache::lookup(const Board& cellValues, const Board& roomIds,
+						   CachedResult* result) {
+	if (!isOpen() || !fitsInSlot(cellValues)) {
+		missCount++;
+		return false;
+	}
+	CanonicalPuzzle canonical = canonicalizePuzzle(cellValues, roomIds);
+	Slot copy;
+	if (!find(keyOf(canonical), &copy) ||
+		copy.height != canonical.cellValues.size() ||
+		copy.width != canonical.cellValues[0].size()) {
+		missCount++;
+		return false;
+	}
+	result->solutionCount = copy.solutionCount;
+	result->solution.clear();
+	if (copy.hasSolution) {
+		Board solution(copy.height, std::vector<int>(copy.width));
+		for (int i = 0; i < copy.height * copy.width; i++) {
+			solution[i / copy.width][i % copy.width] =
+				copy.cells[i / 2] >> (i % 2 * 4) & 0xF;
+		}
+		solution = untransformBoard(solution, canonical.transform);
+		for (int r = 0; r < cellValues.size(); r++) {
+			for (int c = 0; c < cellValues[r].size(); c++) {
+				if (cellValues[r][c] && cellValues[r][c] != solution[r][c]) {
+					missCount++;
+					return false;
+				}
+			}
+		}
+		result->solution.swap(solution);
+	}
+	hitCount++;
+	return true;
+}
+
+void SolutionCache::store(const Board& cellValues, const Board& roomIds,
+						  const CachedResult& result) {
+	if (!isOpen() || !writable || !fitsInSlot(cellValues)) return;
+	bool packable = !result.solution.empty();
+	for (const auto& row : result.solution) {
+		for (int value : row) {
+			if (value < 0 || value > 15) packable = false;
+		}
+	}
+	if (result.solutionCount < 0 && !packable) return;
+	CanonicalPuzzle canonical = canonicalizePuzzle(cellValues, roomIds);
+	Fingerprint fingerprint = keyOf(canonical);
+	Board solution;
+	if (packable) {
+		solution = transformBoard(result.solution, canonical.transform);
+	}
+
+	std::lock_guard<std::mutex> lock(storeMutex);
+	flock(fd, LOCK_EX);
+	// Only stores change slots, so with the lock held they can be read
+	// directly.
+	size_t home = fingerprint.low % slotCount;
+	Slot* target = &slots[home];
+	bool known = false;
+	for (int probe = 0; probe < kProbes; probe++) {
+		Slot& slot = slots[(home + probe) % slotCount];
+		if (slot.high == fingerprint.high && slot.low == fingerprint.low) {
+			target = &slot;
+			known = true;
+			break;
+		}
+		if (!slot.high && !slot.low) {
+			target = &slot;
+			break;
+		}
+	}
+	Slot updated;
+	if (known) {
+		updated = *target;
+	} else {
+		std::memset(&updated, 0, sizeof(updated));
+		updated.high = fingerprint.high;
+		updated.low = fingerprint.low;
+		updated.solutionCount = -1;
+		updated.height = canonical.cellValues.size();
+		updated.width = canonical.cellValues[0].size();
+	}
+	if (result.solutionCount >= 0) {
+		updated.solutionCount = result.solutionCount;
+	}
+	if (packable && !updated.hasSolution) {
+		updated.hasSolution = 1;
+		for (int i = 0; i < updated.height * updated.width; i++) {
+			int value = solution[i / updated.width][i % updated.width];
+			updated.cells[i / 2] |= value << (i % 2 * 4);
+		}
+	}
+
+	// A writer that died part way through leaves the sequence odd, which the
+	// next write carries on from.
+	uint64_t writing = target->sequence | 1;
+	__atomic_store_n(&target->sequence, writing, __ATOMIC_RELAXED);
+	std::atomic_thread_fence(std::memory_order_release);
+	std::memcpy(reinterpret_cast<char*>(target) + sizeof(uint64_t),
+				reinterpret_cast<const char*>(&updated) + sizeof(uint64_t),
+				sizeof(Slot) - sizeof(uint64_t));
+	__atomic_store_n(&target->sequence, writing + 1, __ATOMIC_RELEASE);
+	flock(fd, LOCK_UN);
+}
@@ -0,0 +1,106 @@
+//
+//  solution_cache.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef solution_cache_h
+#define solution_cache_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "canonical_form.h"
+#include "typedefs.h"
+
+// What's known about a puzzle's solutions.
+struct CachedResult {
+	// How many solutions there are, or -1 if that isn't known (only that there
+	// is at least one).
+	long long solutionCount = -1;
+	// One of the solutions, or empty if none is known.
+	Board solution;
+
+	// Whether this is enough to answer a search for one solution, for every
+	// solution, or for the number of solutions.
+	bool answersSingle() const {
+		return solutionCount == 0 || !solution.empty();
+	}
+	bool answersAll() const {
+		return solutionCount == 0 ||
+			   (solutionCount == 1 && !solution.empty());
+	}
+	bool answersCount() const { return solutionCount >= 0; }
+};
+
+// Results of finished searches, kept in a file so that they outlive the
+// process and can be shared by every process using the same file. Puzzles are
+// keyed by the fingerprint of their canonical form (see canonical_form.h), so
+// rotating or reflecting a puzzle, or renumbering its rooms, doesn't stop it
+// being found. Solutions are kept the way the canonical form is turned, and
+// turned back on the way out.
+//
+// The file is a fixed number of slots, set when it's created, mapped into
+// memory and probed as an open-addressing hash table. Lookups take no locks:
+// each slot carries a sequence number that's odd while the slot is being
+// written, and a lookup that sees it change while copying the slot treats it as
+// a miss. Stores are serialized by a lock on the file, so any number of
+// processes can look up and store at once. Once the probed slots are full, a
+// store replaces the first of them.
+//
+// Only boards of up to kMaxCells cells and values up to 15 can be cached.
+class SolutionCache {
+   public:
+	static const int kMaxCells = 256;
+
+	// Opens the cache at `path`, creating it with `capacity` slots if it
+	// doesn't exist. If it can't be written, it's opened for lookups only.
+	// Check isOpen() before use.
+	SolutionCache(const std::string& path, size_t capacity = 1 << 16);
+	~SolutionCache();
+	SolutionCache(const SolutionCache&) = delete;
+	SolutionCache& operator=(const SolutionCache&) = delete;
+
+	// False if the file couldn't be opened or created, or isn't a cache.
+	bool isOpen() const { return slots != nullptr; }
+
+	// Fills in `result` with what's known about the puzzle. Returns false if
+	// nothing is. A known solution is checked against the clues, so a
+	// fingerprint collision can't hand out a wrong one.
+	bool lookup(const Board& cellValues, const Board& roomIds,
+				CachedResult* result);
+
+	// Records what a finished search found, merging it with anything already
+	// known. Does nothing if the puzzle can't be cached or the cache is
+	// read-only.
+	void store(const Board& cellValues, const Board& roomIds,
+			   const CachedResult& result);
+
+	// Lookups that found something, and that didn't.
+	long long hits() const { return hitCount; }
+	long long misses() const { return missCount; }
+
+   private:
+	struct Slot;
+
+	// Copies the slot holding `fingerprint` into `copy`, if there is one.
+	bool find(const Fingerprint& fingerprint, Slot* copy) const;
+
+	int fd = -1;
+	bool writable = false;
+	void* mapping = nullptr;
+	size_t mappingSize = 0;
+	Slot* slots = nullptr;
+	size_t slotCount = 0;
+	// Threads share the file descriptor, and with it its lock, so they need
+	// one of their own as well.
+	std::mutex storeMutex;
+	std::atomic<long long> hitCount{0}, missCount{0};
+};
+
+#endif /* solution_cache_h */
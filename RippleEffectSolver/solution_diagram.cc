@@ -0,0 +1,376 @@
+//
+//  solution_diagram.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "solution_diagram.h"
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "print_board.h"
+#include "solve_puzzle.h"
+#include "typedefs.h"
+#include "validity_checks.h"
+
+// What's left to solve on a partial board, as a string that two partial
+// boards share exactly when they leave the same subproblem. Everything below a
+// partial board depends only on its empty cells and what constrains them:
+// which values each room with empty cells has used, and any filled cell close
+// enough to an empty one in its row or column to ripple into it. So a cell is
+// written as its value if it's empty (0) or within ripple distance of an empty
+// cell and as 0xFF otherwise, followed by the used values of every room that
+// still has empty cells.
+static std::string residualKey(const Board& cellValues,
+							   const RoomMap& roomMap) {
+	int height = (int)cellValues.size(), width = (int)cellValues[0].size();
+	std::string key;
+	key.reserve(width * height + 16);
+	for (int r = 0; r < height; r++) {
+		for (int c = 0; c < width; c++) {
+			int value = cellValues[r][c];
+			bool constrains = !value;
+			for (int d = 1; d <= value && !constrains; d++) {
+				constrains = (c - d >= 0 && !cellValues[r][c - d]) ||
+							 (c + d < width && !cellValues[r][c + d]) ||
+							 (r - d >= 0 && !cellValues[r - d][c]) ||
+							 (r + d < height && !cellValues[r + d][c]);
+			}
+			key += constrains ? (char)value : '\xFF';
+		}
+	}
+	std::vector<bool> used;
+	for (const auto& roomAndCells : roomMap) {
+		const CellList& cellsInRoom = roomAndCells.second;
+		used.assign(cellsInRoom.size() + 1, false);
+		bool open = false;
+		for (const auto& cell : cellsInRoom) {
+			int value = cellValues[cell.first][cell.second];
+			open = open || !value;
+			used[value] = true;
+		}
+		if (!open) continue;
+		for (int value = 1; value < used.size(); value++) {
+			if (used[value]) key += (char)value;
+		}
+		key += '\0';
+	}
+	return key;
+}
+
+SolutionDiagram::SolutionDiagram(const Board& cellValues, const Board& roomIds,
+								 const RoomMap& roomMap,
+								 const std::map<int, int>& cellsCompletedInRoom,
+								 int verbosity)
+	: rootBoard(cellValues) {
+	std::map<int, int> completed = cellsCompletedInRoom;
+	fillKnownCellsInBoard(rootBoard, roomIds, roomMap, completed, verbosity);
+	if (validateCompleteBoard(rootBoard, roomIds, roomMap)) {
+		root = kAccept;
+		return;
+	}
+	// Subproblems already compiled (see residualKey), and the node each one
+	// became.
+	std::map<std::string, int> seen;
+	root = build(rootBoard, roomIds, roomMap, completed, verbosity, seen);
+	switch (verbosity) {
+		case 2:
+		case 1:
+			std::cout << "Compiled " << seen.size()
+					  << " subproblems into a diagram of " << nodes.size()
+					  << " nodes and " << edgeCount() << " edges."
+					  << std::endl;
+		default:
+			break;
+	}
+}
+
+int SolutionDiagram::build(const Board& cellValues, const Board& roomIds,
+						   const RoomMap& roomMap,
+						   const std::map<int, int>& cellsCompletedInRoom,
+						   int verbosity, std::map<std::string, int>& seen) {
+	std::string key = residualKey(cellValues, roomMap);
+	const auto& existing = seen.find(key);
+	if (existing != seen.end()) {
+		return existing->second;
+	}
+
+	// Branch on the first empty cell, just like findAllSolutions.
+	Node node;
+	node.cell = {-1, -1};
+	for (int r = 0; r < cellValues.size() && node.cell.first == -1; r++) {
+		for (int c = 0; c < cellValues[r].size(); c++) {
+			if (!cellValues[r][c]) {
+				node.cell = {r, c};
+				break;
+			}
+		}
+	}
+	int r, c;
+	std::tie(r, c) = node.cell;
+	int room = roomIds[r][c];
+	const CellList& cellsInRoom = roomMap.at(room);
+	for (int value = 1; value <= cellsInRoom.size(); value++) {
+		if (!checkRoom(node.cell, cellsInRoom, value, cellValues) ||
+			!checkRow(node.cell, value, cellValues) ||
+			!checkColumn(node.cell, value, cellValues)) {
+			continue;
+		}
+		Board branchValues = cellValues;
+		std::map<int, int> branchCompleted = cellsCompletedInRoom;
+		branchValues[r][c] = value;
+		branchCompleted[room]++;
+		switch (verbosity) {
+			case 2:
+				printBoard(branchValues, roomIds);
+			case 1:
+				std::cout << "Branching by filling (" << r + 1 << ", " << c + 1
+						  << ") with value " << value << "." << std::endl;
+			default:
+				break;
+		}
+		fillKnownCellsInBoard(branchValues, roomIds, roomMap, branchCompleted,
+							  verbosity);
+
+		Edge edge;
+		edge.value = value;
+		if (validateCompleteBoard(branchValues, roomIds, roomMap)) {
+			edge.child = kAccept;
+		} else {
+			edge.child = build(branchValues, roomIds, roomMap, branchCompleted,
+							   verbosity, seen);
+			if (edge.child == kReject) {
+				continue;
+			}
+		}
+		for (int row = 0; row < branchValues.size(); row++) {
+			for (int col = 0; col < branchValues[row].size(); col++) {
+				if (branchValues[row][col] != cellValues[row][col] &&
+					!(row == r && col == c)) {
+					edge.implied.push_back(
+						{{row, col}, branchValues[row][col]});
+				}
+			}
+		}
+		node.edges.push_back(std::move(edge));
+	}
+
+	int index = node.edges.empty() ? kReject : addUnique(std::move(node));
+	seen.emplace(std::move(key), index);
+	return index;
+}
+
+int SolutionDiagram::addUnique(Node&& node) {
+	std::vector<int> key = {node.cell.first, node.cell.second};
+	for (const auto& edge : node.edges) {
+		key.push_back(edge.value);
+		key.push_back(edge.child);
+		key.push_back((int)edge.implied.size());
+		for (const auto& cellAndValue : edge.implied) {
+			key.push_back(cellAndValue.first.first);
+			key.push_back(cellAndValue.first.second);
+			key.push_back(cellAndValue.second);
+		}
+	}
+	const auto& existing = uniqueNodes.find(key);
+	if (existing != uniqueNodes.end()) {
+		return existing->second;
+	}
+	nodes.push_back(std::move(node));
+	uniqueNodes[key] = (int)nodes.size() - 1;
+	return (int)nodes.size() - 1;
+}
+
+size_t SolutionDiagram::edgeCount() const {
+	size_t edges = 0;
+	for (const auto& node : nodes) {
+		edges += node.edges.size();
+	}
+	return edges;
+}
+
+std::vector<unsigned long long> SolutionDiagram::subtreeCounts() const {
+	// Children come first, so one forward pass does it.
+	std::vector<unsigned long long> counts(nodes.size());
+	for (int i = 0; i < nodes.size(); i++) {
+		for (const auto& edge : nodes[i].edges) {
+			counts[i] += edge.child == kAccept ? 1 : counts[edge.child];
+		}
+	}
+	return counts;
+}
+
+unsigned long long SolutionDiagram::solutionCount() const {
+	switch (root) {
+		case kAccept:
+			return 1;
+		case kReject:
+			return 0;
+		default:
+			return subtreeCounts()[root];
+	}
+}
+
+std::vector<std::vector<std::map<int, unsigned long long>>>
+SolutionDiagram::valueFrequencies() const {
+	std::vector<std::vector<std::map<int, unsigned long long>>> frequencies;
+	for (const auto& row : rootBoard) {
+		frequencies.emplace_back(row.size());
+	}
+	unsigned long long total = solutionCount();
+	if (!total) {
+		return frequencies;
+	}
+	// Everything known at the root is in every solution.
+	for (int r = 0; r < rootBoard.size(); r++) {
+		for (int c = 0; c < rootBoard[r].size(); c++) {
+			if (rootBoard[r][c]) {
+				frequencies[r][c][rootBoard[r][c]] += total;
+			}
+		}
+	}
+	if (root == kAccept) {
+		return frequencies;
+	}
+
+	// Every solution through an edge has all of that edge's assignments, and
+	// there are (paths into the node) * (solutions below the edge) of those.
+	// Walking parents before children means a node's path count is final by
+	// the time it's visited.
+	const auto& counts = subtreeCounts();
+	std::vector<unsigned long long> paths(nodes.size());
+	paths[root] = 1;
+	for (int i = root; i >= 0; i--) {
+		if (!paths[i]) continue;
+		const Node& node = nodes[i];
+		for (const auto& edge : node.edges) {
+			unsigned long long below =
+				edge.child == kAccept ? 1 : counts[edge.child];
+			unsigned long long through = paths[i] * below;
+			frequencies[node.cell.first][node.cell.second][edge.value] +=
+				through;
+			for (const auto& cellAndValue : edge.implied) {
+				frequencies[cellAndValue.first.first]
+						   [cellAndValue.first.second][cellAndValue.second] +=
+					through;
+			}
+			if (edge.child != kAccept) {
+				paths[edge.child] += paths[i];
+			}
+		}
+	}
+	return frequencies;
+}
+
+Board SolutionDiagram::consensus() const {
+	Board aggregate = rootBoard;
+	const auto& frequencies = valueFrequencies();
+	for (int r = 0; r < aggregate.size(); r++) {
+		for (int c = 0; c < aggregate[r].size(); c++) {
+			aggregate[r][c] = frequencies[r][c].size() == 1
+								  ? frequencies[r][c].begin()->first
+								  : 0;
+		}
+	}
+	return aggregate;
+}
+
+SolutionDiagram SolutionDiagram::restrict(const Cell& cell, int value) const {
+	SolutionDiagram restricted;
+	restricted.rootBoard = rootBoard;
+	int existing = rootBoard[cell.first][cell.second];
+	if (existing && existing != value) {
+		restricted.root = kReject;
+	} else if (root == kAccept || root == kReject) {
+		restricted.root = root;
+	} else {
+		// One memo for subtrees that still need to place the value, and one
+		// for those below an edge that already did.
+		std::map<int, int> memos[2];
+		restricted.root =
+			restricted.restrictNode(*this, root, cell, value, existing, memos);
+	}
+	return restricted;
+}
+
+int SolutionDiagram::restrictNode(const SolutionDiagram& source, int index,
+								  const Cell& cell, int value, bool decided,
+								  std::map<int, int> memos[2]) {
+	const auto& existing = memos[decided].find(index);
+	if (existing != memos[decided].end()) {
+		return existing->second;
+	}
+	const Node& original = source.nodes[index];
+	Node node;
+	node.cell = original.cell;
+	for (const auto& originalEdge : original.edges) {
+		// Does this edge place anything in `cell`, and is it the right value?
+		int placed = original.cell == cell ? originalEdge.value : 0;
+		for (const auto& cellAndValue : originalEdge.implied) {
+			if (cellAndValue.first == cell) {
+				placed = cellAndValue.second;
+			}
+		}
+		if (placed && placed != value) {
+			continue;
+		}
+		bool decidedBelow = decided || placed;
+		Edge edge = originalEdge;
+		if (edge.child == kAccept) {
+			// Every cell is filled by now, so it had better be decided.
+			if (!decidedBelow) continue;
+		} else {
+			edge.child = restrictNode(source, originalEdge.child, cell, value,
+									  decidedBelow, memos);
+			if (edge.child == kReject) continue;
+		}
+		node.edges.push_back(std::move(edge));
+	}
+	int result = node.edges.empty() ? kReject : addUnique(std::move(node));
+	memos[decided][index] = result;
+	return result;
+}
+
+void SolutionDiagram::forEachSolution(
+	const std::function<bool(const Board&)>& visitor) const {
+	if (root == kReject) {
+		return;
+	}
+	Board board = rootBoard;
+	if (root == kAccept) {
+		visitor(board);
+		return;
+	}
+	visit(root, board, visitor);
+}
+
+bool SolutionDiagram::visit(
+	int index, Board& board,
+	const std::function<bool(const Board&)>& visitor) const {
+	const Node& node = nodes[index];
+	for (const auto& edge : node.edges) {
+		board[node.cell.first][node.cell.second] = edge.value;
+		for (const auto& cellAndValue : edge.implied) {
+			board[cellAndValue.first.first][cellAndValue.first.second] =
+				cellAndValue.second;
+		}
+		bool keepGoing = edge.child == kAccept
+							 ? visitor(board)
+							 : visit(edge.child, board, visitor);
+		// Undo this edge before trying the next one.
+		board[node.cell.first][node.cell.second] = 0;
+		for (const auto& cellAndValue : edge.implied) {
+			board[cellAndValue.first.first][cellAndValue.first.second] = 0;
+		}
+		if (!keepGoing) {
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,117 @@
+//
+//  solution_diagram.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef solution_diagram_h
+#define solution_diagram_h
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "typedefs.h"
+
+// A reduced multi-valued decision diagram over every solution to a board.
+//
+// Each node branches on one cell, with one edge per value that leads to at
+// least one solution. Taking an edge places its value in the node's cell and
+// also fills in every cell that propagation could then deduce, so each path
+// from the root to the accepting terminal spells out exactly one solution.
+// Nodes are built by the same fill-then-branch search as findAllSolutions, but
+// partial boards that leave the same subproblem share a single node, however
+// they were reached and whatever was filled in far from their empty cells, as
+// do any two nodes with identical edges. On boards with many solutions the
+// diagram is usually orders of magnitude smaller than the set of solutions,
+// and counting, value frequencies, consensus and clue filtering all run in
+// time proportional to the diagram's size rather than the number of solutions.
+class SolutionDiagram {
+   public:
+	// Compiles every solution to the supplied board.
+	SolutionDiagram(const Board& cellValues, const Board& roomIds,
+					const RoomMap& roomMap,
+					const std::map<int, int>& cellsCompletedInRoom,
+					int verbosity);
+
+	// The number of solutions. Doesn't overflow until 2^64.
+	unsigned long long solutionCount() const;
+
+	// Size of the diagram itself.
+	size_t nodeCount() const { return nodes.size(); }
+	size_t edgeCount() const;
+
+	// Same as generateValueFrequencies, but computed from the diagram.
+	std::vector<std::vector<std::map<int, unsigned long long>>>
+	valueFrequencies() const;
+
+	// Same as aggregateBoards: the cells whose value is the same in every
+	// solution, with every other cell 0. Requires at least one solution.
+	Board consensus() const;
+
+	// A diagram of only the solutions that have `value` in `cell`, i.e. what
+	// adding that clue to the board would leave.
+	SolutionDiagram restrict(const Cell& cell, int value) const;
+
+	// Calls `visitor` with every solution in turn, stopping early if it
+	// returns false.
+	void forEachSolution(
+		const std::function<bool(const Board&)>& visitor) const;
+
+   private:
+	// Special child indices.
+	static const int kAccept = -1;
+	static const int kReject = -2;
+
+	struct Edge {
+		// The value placed in the node's cell.
+		int value;
+		// Everything else filled in as a consequence, as (cell, value).
+		std::vector<std::pair<Cell, int>> implied;
+		// Index into `nodes`, or kAccept.
+		int child;
+	};
+	struct Node {
+		Cell cell;
+		std::vector<Edge> edges;
+	};
+
+	SolutionDiagram() {}
+
+	// Returns the node for the (already propagated, incomplete) board, building
+	// it unless a board leaving the same subproblem has been seen before.
+	// Returns kReject if the board has no solutions.
+	int build(const Board& cellValues, const Board& roomIds,
+			  const RoomMap& roomMap,
+			  const std::map<int, int>& cellsCompletedInRoom, int verbosity,
+			  std::map<std::string, int>& seen);
+	// Adds `node` unless an identical one already exists, and returns its
+	// index either way.
+	int addUnique(Node&& node);
+	// Solution counts below every node, indexed like `nodes`.
+	std::vector<unsigned long long> subtreeCounts() const;
+	// Copies the subtree at `index` of `source` into this diagram, keeping only
+	// solutions with `value` in `cell`. `decided` means an edge above already
+	// placed it.
+	int restrictNode(const SolutionDiagram& source, int index, const Cell& cell,
+					 int value, bool decided, std::map<int, int> memos[2]);
+	bool visit(int index, Board& board,
+			   const std::function<bool(const Board&)>& visitor) const;
+
+	// The board after filling in everything known before the first branch.
+	Board rootBoard;
+	// Index of the root node, kAccept if `rootBoard` is already solved, or
+	// kReject if there are no solutions at all.
+	int root = kReject;
+	// Children always come before their parents.
+	std::vector<Node> nodes;
+	// Serialized nodes, for sharing identical ones.
+	std::map<std::vector<int>, int> uniqueNodes;
+};
+
+#endif /* solution_diagram_h */
@@ -0,0 +1,353 @@
+//
+//  solution_store.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "solution_store.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "typedefs.h"
+
+// The most runs merged at once. Merging more than this takes several passes,
+// each of which merges groups of this many runs into one, so that the number
+// of open files and read buffers stays bounded however many runs there are.
+static const size_t kMergeFanIn = 16;
+
+// Sorting small ranges is quicker by insertion than by partitioning.
+static const size_t kInsertionSortRecords = 16;
+
+static void swapRecords(uint8_t* a, uint8_t* b, size_t size) {
+	if (a != b) std::swap_ranges(a, a + size, b);
+}
+
+// Sorts the `count` records of `size` bytes starting at `data` by memcmp, in
+// place, with a quicksort around a copy of the pivot in `pivot`. Scanning
+// stops at records equal to the pivot on both sides, so runs of duplicate
+// records still split evenly, and only the smaller side is recursed into to
+// bound the stack depth.
+static void sortRecords(uint8_t* data, size_t count, size_t size,
+						uint8_t* pivot) {
+	while (count > kInsertionSortRecords) {
+		// Median of the first, middle and last records.
+		uint8_t* first = data;
+		uint8_t* middle = data + count / 2 * size;
+		uint8_t* last = data + (count - 1) * size;
+		if (std::memcmp(middle, first, size) < 0) {
+			swapRecords(middle, first, size);
+		}
+		if (std::memcmp(last, middle, size) < 0) {
+			swapRecords(last, middle, size);
+			if (std::memcmp(middle, first, size) < 0) {
+				swapRecords(middle, first, size);
+			}
+		}
+		std::memcpy(pivot, middle, size);
+
+		uint8_t* low = data - size;
+		uint8_t* high = data + count * size;
+		while (true) {
+			do {
+				low += size;
+			} while (std::memcmp(low, pivot, size) < 0);
+			do {
+				high -= size;
+			} while (std::memcmp(high, pivot, size) > 0);
+			if (low >= high) break;
+			swapRecords(low, high, size);
+		}
+		// [data, high] <= pivot <= (high, end).
+		size_t below = (high - data) / size + 1;
+		if (below < count - below) {
+			sortRecords(data, below, size, pivot);
+			data += below * size;
+			count -= below;
+		} else {
+			sortRecords(high + size, count - below, size, pivot);
+			count = below;
+		}
+	}
+	for (size_t i = 1; i < count; i++) {
+		for (size_t j = i; j > 0 && std::memcmp(data + (j - 1) * size,
+												 data + j * size, size) > 0;
+			 j--) {
+			swapRecords(data + (j - 1) * size, data + j * size, size);
+		}
+	}
+}
+
+SolutionStore::SolutionStore(int width, int height, size_t memoryLimit,
+							 const std::string& tempDirectory)
+	: width(width),
+	  height(height),
+	  recordSize((width * height + 1) / 2),
+	  memoryLimit(memoryLimit),
+	  tempDirectory(tempDirectory),
+	  pivot(recordSize) {}
+
+SolutionStore::~SolutionStore() {
+	for (const auto& runFile : runFiles) {
+		std::remove(runFile.c_str());
+	}
+	if (!mergedFile.empty()) {
+		std::remove(mergedFile.c_str());
+	}
+}
+
+bool SolutionStore::insert(const Board& board) {
+	if (finished || board.size() != height) {
+		return false;
+	}
+	for (const auto& row : board) {
+		if (row.size() != width) {
+			return false;
+		}
+		for (int value : row) {
+			if (value < 0 || value > 15) {
+				std::cerr << "Value " << value
+						  << " doesn't fit in a packed solution." << std::endl;
+				return false;
+			}
+		}
+	}
+	if (memoryLimit && buffer.capacity() == 0) {
+		// Everything up to the limit goes in this one allocation, which is
+		// never outgrown, so the buffer's memory never exceeds the limit.
+		// Untouched pages of it cost nothing until boards are packed there.
+		buffer.reserve(
+			std::max(recordSize, memoryLimit / recordSize * recordSize));
+	}
+	pack(board, buffer);
+	if (memoryLimit && buffer.size() + recordSize > memoryLimit) {
+		return spill();
+	}
+	return true;
+}
+
+bool SolutionStore::finish() {
+	if (finished) {
+		return true;
+	}
+	finished = true;
+	if (runFiles.empty()) {
+		// Everything fit in memory, so there's nothing to merge.
+		sortAndDeduplicate();
+		uniqueBoards = buffer.size() / recordSize;
+		return true;
+	}
+	if (!buffer.empty() && !spill()) {
+		return false;
+	}
+	std::vector<uint8_t>().swap(buffer);
+
+	// Merge runs kMergeFanIn at a time until few enough are left to merge
+	// into the final result in one go.
+	bool ok = true;
+	while (ok && runFiles.size() > kMergeFanIn) {
+		std::vector<std::string> merged;
+		for (size_t i = 0; ok && i < runFiles.size(); i += kMergeFanIn) {
+			std::vector<std::string> group(
+				runFiles.begin() + i,
+				runFiles.begin() + std::min(runFiles.size(), i + kMergeFanIn));
+			std::string path;
+			ok = mergeRuns(group, "solutions-run-XXXXXX", &path, nullptr);
+			if (!path.empty()) {
+				merged.push_back(path);
+			}
+		}
+		for (const auto& runFile : runFiles) {
+			std::remove(runFile.c_str());
+		}
+		runFiles.swap(merged);
+	}
+	ok = ok && mergeRuns(runFiles, "solutions-merged-XXXXXX", &mergedFile,
+						 &uniqueBoards);
+	for (const auto& runFile : runFiles) {
+		std::remove(runFile.c_str());
+	}
+	runFiles.clear();
+	if (!ok) {
+		std::cerr << "Failed to merge spilled solutions." << std::endl;
+	}
+	return ok;
+}
+
+bool SolutionStore::forEach(
+	const std::function<bool(const Board&)>& visitor) const {
+	if (!finished) {
+		return false;
+	}
+	Board board(height, std::vector<int>(width));
+	if (mergedFile.empty()) {
+		for (size_t offset = 0; offset < buffer.size(); offset += recordSize) {
+			unpack(&buffer[offset], board);
+			if (!visitor(board)) {
+				break;
+			}
+		}
+		return true;
+	}
+	FILE* merged = std::fopen(mergedFile.c_str(), "rb");
+	if (!merged) {
+		return false;
+	}
+	// Read a few thousand records at a time rather than one by one.
+	const size_t recordsPerChunk = std::max<size_t>(1, (1 << 16) / recordSize);
+	std::vector<uint8_t> chunk(recordsPerChunk * recordSize);
+	size_t records;
+	bool stopped = false;
+	while (!stopped && (records = std::fread(chunk.data(), recordSize,
+											 recordsPerChunk, merged)) > 0) {
+		for (size_t i = 0; i < records; i++) {
+			unpack(&chunk[i * recordSize], board);
+			if (!visitor(board)) {
+				stopped = true;
+				break;
+			}
+		}
+	}
+	std::fclose(merged);
+	return true;
+}
+
+void SolutionStore::pack(const Board& board,
+						 std::vector<uint8_t>& packed) const {
+	// Even cells go in the high nibble so that comparing packed records with
+	// memcmp orders them the same way std::set<Board> would.
+	size_t start = packed.size();
+	packed.resize(start + recordSize, 0);
+	int i = 0;
+	for (const auto& row : board) {
+		for (int value : row) {
+			packed[start + i / 2] |= i % 2 ? value : value << 4;
+			i++;
+		}
+	}
+}
+
+void SolutionStore::unpack(const uint8_t* record, Board& board) const {
+	int i = 0;
+	for (auto& row : board) {
+		for (auto& value : row) {
+			value = i % 2 ? record[i / 2] & 0xF : record[i / 2] >> 4;
+			i++;
+		}
+	}
+}
+
+void SolutionStore::sortAndDeduplicate() {
+	size_t count = buffer.size() / recordSize;
+	uint8_t* data = buffer.data();
+	sortRecords(data, count, recordSize, pivot.data());
+	size_t unique = 0;
+	for (size_t i = 0; i < count; i++) {
+		uint8_t* record = data + i * recordSize;
+		if (unique && std::memcmp(data + (unique - 1) * recordSize, record,
+								  recordSize) == 0) {
+			continue;
+		}
+		if (unique != i) {
+			std::memcpy(data + unique * recordSize, record, recordSize);
+		}
+		unique++;
+	}
+	buffer.resize(unique * recordSize);
+}
+
+bool SolutionStore::mergeRuns(const std::vector<std::string>& inputs,
+							  const char* name, std::string* output,
+							  size_t* records) const {
+	// Classic k-way merge. Each run is already sorted and duplicate-free, so
+	// only the smallest record across all runs needs comparing to the last
+	// one written.
+	std::vector<FILE*> runs;
+	std::vector<std::vector<uint8_t>> heads(inputs.size(),
+											std::vector<uint8_t>(recordSize));
+	const auto greater = [&heads, this](int a, int b) {
+		return std::memcmp(heads[a].data(), heads[b].data(), recordSize) > 0;
+	};
+	std::priority_queue<int, std::vector<int>, decltype(greater)> queue(
+		greater);
+	bool ok = true;
+	for (int i = 0; i < inputs.size(); i++) {
+		FILE* run = std::fopen(inputs[i].c_str(), "rb");
+		runs.push_back(run);
+		if (!run) {
+			ok = false;
+		} else if (std::fread(heads[i].data(), recordSize, 1, run) == 1) {
+			queue.push(i);
+		}
+	}
+	std::string path = tempDirectory + "/" + name;
+	int fd = ok ? mkstemp(&path[0]) : -1;
+	FILE* merged = fd == -1 ? nullptr : fdopen(fd, "wb");
+	if (merged) {
+		*output = path;
+		size_t written = 0;
+		std::vector<uint8_t> last;
+		while (!queue.empty()) {
+			int i = queue.top();
+			queue.pop();
+			if (last.empty() ||
+				std::memcmp(last.data(), heads[i].data(), recordSize) != 0) {
+				if (std::fwrite(heads[i].data(), recordSize, 1, merged) != 1) {
+					ok = false;
+					break;
+				}
+				last = heads[i];
+				written++;
+			}
+			if (std::fread(heads[i].data(), recordSize, 1, runs[i]) == 1) {
+				queue.push(i);
+			}
+		}
+		ok = std::fclose(merged) == 0 && ok;
+		if (records) {
+			*records = written;
+		}
+	} else {
+		ok = false;
+	}
+	for (FILE* run : runs) {
+		if (run) {
+			std::fclose(run);
+		}
+	}
+	return ok;
+}
+
+bool SolutionStore::spill() {
+	sortAndDeduplicate();
+	std::string path = tempDirectory + "/solutions-run-XXXXXX";
+	int fd = mkstemp(&path[0]);
+	FILE* run = fd == -1 ? nullptr : fdopen(fd, "wb");
+	if (!run) {
+		std::cerr << "Failed to create a spill file in " << tempDirectory
+				  << "." << std::endl;
+		return false;
+	}
+	runFiles.push_back(path);
+	runsSpilled++;
+	bool ok =
+		std::fwrite(buffer.data(), 1, buffer.size(), run) == buffer.size();
+	ok = std::fclose(run) == 0 && ok;
+	buffer.clear();
+	if (!ok) {
+		std::cerr << "Failed to write solutions to " << path << "."
+				  << std::endl;
+	}
+	return ok;
+}
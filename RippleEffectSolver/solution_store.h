@@ -0,0 +1,94 @@
+//
+//  solution_store.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef solution_store_h
+#define solution_store_h
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "typedefs.h"
+
+// A set of equally sized boards that doesn't have to fit in memory. Boards are
+// packed at 4 bits per cell (so no value may exceed 15), which is roughly 50
+// bytes for a 10x10 solution compared to well over 1KB as a std::set<Board>
+// node. Once the packed boards in memory reach the memory limit, they are
+// sorted in place, deduplicated and spilled to a temporary file as a run.
+// finish() then merges the runs, a bounded number at a time, into one sorted,
+// duplicate-free sequence that forEach() streams back one board at a time.
+class SolutionStore {
+   public:
+	// `memoryLimit` is in bytes and covers only the packed boards; 0 means
+	// never spill. Spill files are created in `tempDirectory` and removed when
+	// the store is destroyed.
+	SolutionStore(int width, int height, size_t memoryLimit,
+				  const std::string& tempDirectory = "/tmp");
+	~SolutionStore();
+	SolutionStore(const SolutionStore&) = delete;
+	SolutionStore& operator=(const SolutionStore&) = delete;
+
+	// Adds a board to the store. Returns false if the board doesn't match the
+	// store's dimensions, contains a value that won't fit in 4 bits, or a run
+	// couldn't be spilled to disk. Not valid after finish().
+	bool insert(const Board& board);
+
+	// Sorts, deduplicates and merges everything inserted so far. Returns false
+	// if a spill file couldn't be read or written. Must be called before
+	// size() and forEach().
+	bool finish();
+
+	// The number of unique boards in the store.
+	size_t size() const { return uniqueBoards; }
+
+	// The number of runs spilled to disk so far.
+	int spilledRuns() const { return runsSpilled; }
+
+	// Calls `visitor` with every unique board, in sorted order. Returning false
+	// from `visitor` stops the iteration early. Only one board is unpacked at
+	// a time, so this is safe to use on stores far larger than memory.
+	bool forEach(const std::function<bool(const Board&)>& visitor) const;
+
+   private:
+	// Packs `board` onto the end of `packed`.
+	void pack(const Board& board, std::vector<uint8_t>& packed) const;
+	// Unpacks the record starting at `record` into `board`.
+	void unpack(const uint8_t* record, Board& board) const;
+	// Sorts and deduplicates the records in `buffer` in place.
+	void sortAndDeduplicate();
+	// Writes `buffer` to a new run file and clears it.
+	bool spill();
+	// Merges the runs in `inputs` into a new file named after the mkstemp
+	// template `name`, storing its path in `output` and, if non-null, its
+	// record count in `records`. Leaves the input files in place.
+	bool mergeRuns(const std::vector<std::string>& inputs, const char* name,
+				   std::string* output, size_t* records) const;
+
+	const int width, height;
+	// Bytes per packed board.
+	const size_t recordSize;
+	const size_t memoryLimit;
+	const std::string tempDirectory;
+	// Packed boards not yet spilled, back to back. With a memory limit, its
+	// capacity is set once to the limit.
+	std::vector<uint8_t> buffer;
+	// One record's worth of room for sorting with.
+	std::vector<uint8_t> pivot;
+	// Sorted, deduplicated runs on disk, until they're merged.
+	std::vector<std::string> runFiles;
+	int runsSpilled = 0;
+	// The merged result, if anything was ever spilled. Otherwise the result
+	// lives in `buffer`.
+	std::string mergedFile;
+	size_t uniqueBoards = 0;
+	bool finished = false;
+};
+
+#endif /* solution_store_h */
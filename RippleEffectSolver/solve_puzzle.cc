@@ -9,126 +9,1000 @@
 #include "solve_puzzle.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
 #include <iostream>
 #include <map>
+#include <random>
 #include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "all_different.h"
+#include "checkpoint.h"
+#include "fixed_size_kernels.h"
+#include "learning_solver.h"
+#include "perf_counters.h"
 #include "print_board.h"
+#include "room_tables.h"
+#include "search_trace.h"
+#include "solver_options.h"
+#include "transposition_table.h"
 #include "typedefs.h"
 #include "validity_checks.h"
 
-std::pair<bool, Board> findSingleSolution(
-	Board /* intentional copy */ cellValues, const Board& roomIds,
-	const RoomMap& roomMap,
-	std::map<int, int> /* intentional copy */ cellsCompletedInRoom,
-	int verbosity) {
-	// First, complete the things we know for sure.
-	fillKnownCellsInBoard(cellValues, roomIds, roomMap, cellsCompletedInRoom,
-						  verbosity);
+// Values ruled out of each cell so far, as bits indexed by value. Only values
+// below 64 are ever ruled out this way, which rooms never come close to.
+typedef std::vector<std::vector<uint64_t>> EliminatedValues;
 
-	// At this point, we're either done the puzzle or need to branch.
-	if (validateCompleteBoard(cellValues, roomIds, roomMap)) {
-		return {true, cellValues};
+// The fillings of each room with a table (see RoomTables) that still agree with
+// the board, as indices into the room's table, in the order of the tables.
+// Every room keeps its entry once it's complete, so that copying one into
+// another of the same shape reuses its storage.
+typedef std::vector<std::pair<int, std::vector<int>>> RoomSurvivors;
+
+// How a search node branches: either one child per value that could go in
+// `cell`, or, when branching on rooms, one child per remaining filling of
+// `room` (as indices into its table).
+struct Branching {
+	Cell cell;
+	std::vector<int> values;
+	int room = -1;
+	std::vector<int> fillings;
+
+	size_t size() const {
+		return room == -1 ? values.size() : fillings.size();
 	}
+};
 
-	// Now, we need to make a choice. Find the first empty cell and fill it with
-	// its first possibility, then recurse. If that returns a valid solution,
-	// return that. Otherwise, try the next value until one is found or all are
-	// exhausted. This is indeed DFS, not BFS, but it is guaranteed to
-	// eventually terminate for any input due to the nature of the puzzle.
-	switch (verbosity) {
-		case 2:
-		case 1:
-			std::cout << "Unable to fill in any more cells with certainty. "
-						 "Beginning to branch."
-					  << std::endl;
-		default:
-			break;
+// One level of a search: a partial board and everything worked out about it.
+struct SearchFrame {
+	Board cellValues;
+	std::map<int, int> cellsCompletedInRoom;
+	uint64_t hash, entryHash;
+	EliminatedValues eliminated;
+	// The cells propagation filled in, only kept with a transposition table.
+	CellList filledCells;
+	RoomSurvivors survivors;
+	Branching branching;
+	// Only used by enumerateSolutions, which keeps its own stack of frames
+	// rather than recursing. Whether expandNode has been run on the board yet,
+	// and how many of the branches have been started since.
+	bool expanded;
+	int next;
+	// Whether the frame was rebuilt from a checkpoint, in which case the
+	// solutions below it that were visited before the checkpoint aren't
+	// counted, so it can't go in the transposition table.
+	bool resumed;
+	// The node and solution counts when the frame was expanded.
+	long long nodesBefore, visitedBefore;
+};
+
+// All the memory a search works in. Frames are reused from node to node, and
+// copying a board or map into one that already has the right shape reuses its
+// storage, so once a search has warmed up, expanding and branching with the
+// default options doesn't allocate at all. Solver keeps one between searches.
+struct SearchWorkspace {
+	// One frame per search depth. Every branch fills in at least one cell, so
+	// a search never needs more than one per empty cell plus one.
+	std::vector<SearchFrame> frames;
+	// A scratch frame for probing to try values on.
+	SearchFrame probe;
+	FillScratch fill;
+	// Scratch space for the helpers below, each of which only uses it while
+	// not calling another that does.
+	std::vector<char> usedNumber, placeable;
+	std::vector<int> probeValues, remaining;
+	CellList candidates, targets;
+	// Scratch space for enforceRoomMatching: one room's empty cells, their
+	// domains before and after pruning, and the matching that prunes them.
+	CellList matchingCells;
+	std::vector<uint64_t> matchingDomains, matchingPruned;
+	MatchingGraph matching;
+	// Scratch space for orderBranches: each choice's score and position, the
+	// choices in their new order, and the cells constrainingScore looks at.
+	std::vector<std::pair<int, int>> scored;
+	std::vector<int> ordered;
+	CellList affected;
+	// Every filling of every room with a table, which the root of a search
+	// starts from and every frame's survivors are sized to, and scratch space
+	// for enforceRoomTables: one room's domains and the values its remaining
+	// fillings put in each cell.
+	RoomSurvivors allSurvivors;
+	std::vector<uint64_t> tableDomains, tableUsed;
+
+	// Makes sure the frames can go as deep as a search of `cellValues` might,
+	// so that references to them stay valid as the search goes deeper, that
+	// the room matching scratch fits the largest room in `roomMap`, and that
+	// the frames have room for every filling in `roomTables`, if not null.
+	void reserveFor(const Board& cellValues, const RoomMap& roomMap,
+					const RoomTables* roomTables) {
+		size_t depth = cellValues.size() * cellValues[0].size() -
+					   countKnownCells(cellValues) + 2;
+		if (frames.capacity() < depth) frames.reserve(depth);
+		size_t largestRoom = 0;
+		for (const auto& roomAndCells : roomMap) {
+			largestRoom = std::max(largestRoom, roomAndCells.second.size());
+		}
+		if (matchingCells.capacity() < largestRoom) {
+			matchingCells.reserve(largestRoom);
+			matchingDomains.reserve(largestRoom);
+			matchingPruned.reserve(largestRoom);
+			matching.reserve((int)largestRoom);
+			tableDomains.reserve(largestRoom);
+			tableUsed.reserve(largestRoom);
+		}
+		if (roomTables && !hasAllFillings(*roomTables)) {
+			allSurvivors.clear();
+			for (const auto& roomAndTable : roomTables->allTables()) {
+				allSurvivors.emplace_back(roomAndTable.first,
+										  std::vector<int>());
+				std::vector<int>& indices = allSurvivors.back().second;
+				for (int i = 0; i < roomAndTable.second.size(); i++) {
+					indices.push_back(i);
+				}
+			}
+			for (auto& frame : frames) {
+				fitFillings(frame);
+			}
+			fitFillings(probe);
+		}
 	}
-	for (int r = 0; r < cellValues.size(); r++) {
-		for (int c = 0; c < cellValues[r].size(); c++) {
-			if (cellValues[r][c]) {
+
+	// The frame at `depth`, adding it if this is as deep as it has been.
+	SearchFrame& frame(int depth) {
+		if (depth == frames.size()) {
+			frames.emplace_back();
+			fitFillings(frames.back());
+		}
+		return frames[depth];
+	}
+
+   private:
+	// Whether `allSurvivors` is every filling in `roomTables`.
+	bool hasAllFillings(const RoomTables& roomTables) const {
+		const auto& tables = roomTables.allTables();
+		if (allSurvivors.size() != tables.size()) return false;
+		auto survivor = allSurvivors.begin();
+		for (const auto& roomAndTable : tables) {
+			if (survivor->first != roomAndTable.first ||
+				survivor->second.size() != roomAndTable.second.size()) {
+				return false;
+			}
+			++survivor;
+		}
+		return true;
+	}
+
+	// Gives `frame` room for every filling in `allSurvivors`, whether it
+	// survives or is branched into.
+	void fitFillings(SearchFrame& frame) const {
+		frame.survivors = allSurvivors;
+		for (const auto& roomAndFillings : allSurvivors) {
+			frame.branching.fillings.reserve(roomAndFillings.second.size());
+		}
+	}
+};
+
+// Everything the searches below share, other than the board itself.
+struct SearchContext {
+	const Board& roomIds;
+	const RoomMap& roomMap;
+	int verbosity;
+	const SolverOptions& options;
+	SearchWorkspace& workspace;
+	// Nodes visited so far, kept even without stats since the transposition
+	// table needs it to judge how expensive an entry was.
+	long long nodes;
+	// If positive, the search gives up once `nodes` reaches this, setting
+	// `aborted`. Nothing learned after that point can be trusted.
+	long long nodeLimit;
+	bool aborted;
+	// Why the search was aborted, unless it was just `nodeLimit`.
+	SolveStatus status;
+	// Whether the layout's rooms are all contiguous. Without that, no board
+	// counts as solved.
+	bool roomsValid;
+	// Whether ties in the value order are broken at random.
+	bool randomizeTies;
+	std::mt19937_64 random;
+	// This thread's buffer in `options.tracer`, or null if not tracing.
+	TraceBuffer* trace;
+};
+
+// Records an event at `depth` if the search is being traced.
+static void traceEvent(const SearchContext& context, TraceEventKind kind,
+					   int depth, int64_t time, int64_t duration = 0,
+					   int value = 0) {
+	context.trace->record({time, duration, kind, depth, -1, -1, -1, value});
+}
+
+// Records branching into choice `index` of `branching`, as the node at `depth`.
+static void traceBranch(const SearchContext& context,
+						const Branching& branching, int index, int depth) {
+	TraceEvent event = {context.options.tracer->now(), 0,
+						TraceEventKind::kBranch, depth};
+	if (branching.room == -1) {
+		std::tie(event.row, event.column) = branching.cell;
+		event.room = -1;
+		event.value = branching.values[index];
+	} else {
+		std::tie(event.row, event.column) =
+			context.roomMap.at(branching.room)[0];
+		event.room = branching.room;
+		event.value = branching.fillings[index];
+	}
+	context.trace->record(event);
+}
+
+// Records leaving the node at `depth`, if the search is being traced.
+static void traceBacktrack(const SearchContext& context, int depth) {
+	if (context.trace) {
+		traceEvent(context, TraceEventKind::kBacktrack, depth,
+				   context.options.tracer->now());
+	}
+}
+
+// Lists the values that could go in the (empty) cell without breaking any
+// rule in `possibleValues`, in ascending order.
+static void possibleValuesForCell(const Cell& cell, const Board& cellValues,
+								  const SearchContext& context,
+								  std::vector<int>* possibleValues) {
+	int room = context.roomIds[cell.first][cell.second];
+	const CellList& cellsInRoom = context.roomMap.at(room);
+	std::vector<char>& usedNumber = context.workspace.usedNumber;
+	usedNumber.assign(cellsInRoom.size(), false);
+	for (const auto& roomCell : cellsInRoom) {
+		int value = cellValues[roomCell.first][roomCell.second];
+		if (value) {
+			usedNumber[value - 1] = true;
+		}
+	}
+	possibleValues->clear();
+	for (int i = 0; i < usedNumber.size(); i++) {
+		if (!usedNumber[i] && checkRow(cell, i + 1, cellValues) &&
+			checkColumn(cell, i + 1, cellValues)) {
+			possibleValues->push_back(i + 1);
+		}
+	}
+}
+
+// Returns true if the board can't possibly be completed because an empty cell
+// has no value that fits, or a room is missing a value that fits in none of its
+// empty cells.
+static bool hasContradiction(const Board& cellValues,
+							 const std::map<int, int>& cellsCompletedInRoom,
+							 const SearchContext& context) {
+	for (const auto& roomAndCells : context.roomMap) {
+		const CellList& cellsInRoom = roomAndCells.second;
+		const auto& completed = cellsCompletedInRoom.find(roomAndCells.first);
+		if (completed != cellsCompletedInRoom.end() &&
+			completed->second == cellsInRoom.size()) {
+			continue;
+		}
+		std::vector<char>& usedNumber = context.workspace.usedNumber;
+		usedNumber.assign(cellsInRoom.size(), false);
+		for (const auto& cell : cellsInRoom) {
+			int value = cellValues[cell.first][cell.second];
+			if (value) {
+				usedNumber[value - 1] = true;
+			}
+		}
+		// Tracks which missing values fit in at least one empty cell.
+		std::vector<char>& placeable = context.workspace.placeable;
+		placeable.assign(cellsInRoom.size(), false);
+		for (const auto& cell : cellsInRoom) {
+			if (cellValues[cell.first][cell.second]) continue;
+			bool anyFits = false;
+			for (int i = 0; i < usedNumber.size(); i++) {
+				if (!usedNumber[i] && checkRow(cell, i + 1, cellValues) &&
+					checkColumn(cell, i + 1, cellValues)) {
+					anyFits = true;
+					placeable[i] = true;
+				}
+			}
+			if (!anyFits) {
+				return true;
+			}
+		}
+		for (int i = 0; i < usedNumber.size(); i++) {
+			if (!usedNumber[i] && !placeable[i]) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+// The values that could still go in the (empty) cell as bits indexed by value,
+// leaving out any that have been ruled out.
+static uint64_t cellDomain(const Cell& cell, const Board& cellValues,
+						   const SearchContext& context,
+						   const EliminatedValues& eliminated) {
+	const CellList& cellsInRoom =
+		context.roomMap.at(context.roomIds[cell.first][cell.second]);
+	uint64_t used = 0;
+	for (const auto& roomCell : cellsInRoom) {
+		int value = cellValues[roomCell.first][roomCell.second];
+		if (value < 64) used |= 1ULL << value;
+	}
+	uint64_t domain = 0;
+	for (int value = 1; value <= cellsInRoom.size() && value < 64; value++) {
+		if (!(used >> value & 1) && checkRow(cell, value, cellValues) &&
+			checkColumn(cell, value, cellValues)) {
+			domain |= 1ULL << value;
+		}
+	}
+	return domain & ~eliminated[cell.first][cell.second];
+}
+
+// Prunes every room's empty cells down to the values that appear in some way of
+// filling in the whole room (see pruneAllDifferent), and fills in any cell left
+// with just one value. Returns the number of cells filled in, or -1 if some
+// room can't be completed at all.
+static int enforceRoomMatching(Board& cellValues,
+							   std::map<int, int>& cellsCompletedInRoom,
+							   SearchContext& context, int verbosity,
+							   CellList* filledCells,
+							   EliminatedValues& eliminated) {
+	SolverStats* stats = context.options.stats;
+	int cellsFilled = 0;
+	for (const auto& roomAndCells : context.roomMap) {
+		const CellList& cellsInRoom = roomAndCells.second;
+		if (cellsCompletedInRoom[roomAndCells.first] == cellsInRoom.size() ||
+			cellsInRoom.size() >= 64) {
+			continue;
+		}
+		uint64_t missing = 0;
+		for (int value = 1; value <= cellsInRoom.size(); value++) {
+			missing |= 1ULL << value;
+		}
+		SearchWorkspace& workspace = context.workspace;
+		CellList& emptyCells = workspace.matchingCells;
+		emptyCells.clear();
+		for (const auto& cell : cellsInRoom) {
+			int value = cellValues[cell.first][cell.second];
+			if (value) {
+				missing &= ~(1ULL << value);
+			} else {
+				emptyCells.push_back(cell);
+			}
+		}
+		std::vector<uint64_t>& domains = workspace.matchingDomains;
+		domains.clear();
+		for (const auto& cell : emptyCells) {
+			domains.push_back(
+				cellDomain(cell, cellValues, context, eliminated));
+		}
+		std::vector<uint64_t>& pruned = workspace.matchingPruned;
+		pruned = domains;
+		if (!pruneAllDifferent(pruned, missing, &workspace.matching)) {
+			return -1;
+		}
+		for (int i = 0; i < emptyCells.size(); i++) {
+			int r, c;
+			std::tie(r, c) = emptyCells[i];
+			uint64_t removed = domains[i] & ~pruned[i];
+			if (removed) {
+				eliminated[r][c] |= removed;
+				if (stats) {
+					for (; removed; removed &= removed - 1) {
+						stats->matchingEliminations++;
+					}
+				}
+			}
+			if (pruned[i] & (pruned[i] - 1)) {
+				// More than one value left.
 				continue;
 			}
-			// Now determine which values are possible here.
-			int room = roomIds[r][c];
-			std::vector<bool> usedNumber(roomMap.at(room).size(), false);
-			for (const auto& cell : roomMap.at(room)) {
+			int value = 0;
+			while (!(pruned[i] >> value & 1)) {
+				value++;
+			}
+			// Only this room was considered, so an earlier fill in it may
+			// have ruled this value out after all.
+			if (!checkRow(emptyCells[i], value, cellValues) ||
+				!checkColumn(emptyCells[i], value, cellValues)) {
+				return -1;
+			}
+			cellValues[r][c] = value;
+			cellsCompletedInRoom[roomAndCells.first]++;
+			cellsFilled++;
+			if (filledCells) filledCells->push_back(emptyCells[i]);
+			if (stats) stats->matchingFills++;
+			switch (verbosity) {
+				case 2:
+					printBoard(cellValues, context.roomIds);
+				case 1:
+					std::cout << "Filled in a " << value << " at (" << r + 1
+							  << ", " << c + 1
+							  << ") since it's the only value that lets the "
+								 "rest of its room be filled in."
+							  << std::endl;
+				default:
+					break;
+			}
+		}
+	}
+	return cellsFilled;
+}
+
+// Returns true if `value` in both cells would break the ripple rule.
+static bool ripplesInto(const Cell& a, const Cell& b, int value) {
+	return (a.first == b.first && std::abs(a.second - b.second) <= value) ||
+		   (a.second == b.second && std::abs(a.first - b.first) <= value);
+}
+
+// Reasoning across room boundaries. Every room must put each value it's missing
+// in one of the cells that can still take it, so any cell in another room that
+// is within ripple range of all of those cells can't take that value. For
+// example, if a room's only places for a 3 lie on one short stretch of a row,
+// the cells of that row within 3 of both ends of the stretch can't be 3.
+// Rules out every such value, and fills in any cell left with just one value,
+// until nothing changes. Returns the number of cells filled in, or -1 if a cell
+// is left with no values at all.
+static int enforceLineRules(Board& cellValues,
+							std::map<int, int>& cellsCompletedInRoom,
+							SearchContext& context, int verbosity,
+							CellList* filledCells,
+							EliminatedValues& eliminated) {
+	SolverStats* stats = context.options.stats;
+	int height = (int)cellValues.size(), width = (int)cellValues[0].size();
+	int cellsFilled = 0;
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (const auto& roomAndCells : context.roomMap) {
+			int room = roomAndCells.first;
+			const CellList& cellsInRoom = roomAndCells.second;
+			if (cellsCompletedInRoom[room] == cellsInRoom.size() ||
+				cellsInRoom.size() >= 64) {
+				continue;
+			}
+			std::vector<char>& usedNumber = context.workspace.usedNumber;
+			usedNumber.assign(cellsInRoom.size(), false);
+			for (const auto& cell : cellsInRoom) {
 				int value = cellValues[cell.first][cell.second];
 				if (value) {
 					usedNumber[value - 1] = true;
 				}
 			}
-			std::vector<int> possibleValues;
-			for (int i = 0; i < usedNumber.size(); i++) {
-				if (!usedNumber[i]) {
-					possibleValues.push_back(i + 1);
+			for (int value = 1; value <= cellsInRoom.size(); value++) {
+				if (usedNumber[value - 1]) continue;
+				CellList& candidates = context.workspace.candidates;
+				candidates.clear();
+				for (const auto& cell : cellsInRoom) {
+					if (!cellValues[cell.first][cell.second] &&
+						cellDomain(cell, cellValues, context, eliminated) >>
+								value &
+							1) {
+						candidates.push_back(cell);
+					}
 				}
-			}
-			for (int possibility : possibleValues) {
-				if (checkRow({r, c}, possibility, cellValues) &&
-					checkColumn({r, c}, possibility, cellValues)) {
-					// Now we attempt this completion, and undo it if it doesn't
-					// work.
-					cellValues[r][c] = possibility;
-					cellsCompletedInRoom[room]++;
+				if (candidates.empty()) {
+					return -1;
+				}
+				// Anything in range of every candidate is in range of the
+				// first one, so only its row and column need looking at.
+				const Cell& first = candidates[0];
+				CellList& targets = context.workspace.targets;
+				targets.clear();
+				for (int offset = -value; offset <= value; offset++) {
+					if (!offset) continue;
+					if (first.second + offset >= 0 &&
+						first.second + offset < width) {
+						targets.push_back({first.first, first.second + offset});
+					}
+					if (first.first + offset >= 0 &&
+						first.first + offset < height) {
+						targets.push_back({first.first + offset, first.second});
+					}
+				}
+				for (const auto& target : targets) {
+					int r, c;
+					std::tie(r, c) = target;
+					if (cellValues[r][c] || context.roomIds[r][c] == room) {
+						continue;
+					}
+					bool inRangeOfAll = true;
+					for (const auto& candidate : candidates) {
+						if (!ripplesInto(candidate, target, value)) {
+							inRangeOfAll = false;
+							break;
+						}
+					}
+					if (!inRangeOfAll) continue;
+					uint64_t domain =
+						cellDomain(target, cellValues, context, eliminated);
+					uint64_t bit = 1ULL << value;
+					if (!(domain & bit)) continue;
+					eliminated[r][c] |= bit;
+					domain &= ~bit;
+					changed = true;
+					if (stats) stats->lineEliminations++;
+					if (!domain) {
+						return -1;
+					}
+					if (domain & (domain - 1)) {
+						// More than one value left.
+						continue;
+					}
+					int remaining = 0;
+					while (!(domain >> remaining & 1)) {
+						remaining++;
+					}
+					cellValues[r][c] = remaining;
+					cellsCompletedInRoom[context.roomIds[r][c]]++;
+					cellsFilled++;
+					if (filledCells) filledCells->push_back(target);
+					if (stats) stats->lineFills++;
 					switch (verbosity) {
 						case 2:
-							printBoard(cellValues, roomIds);
+							printBoard(cellValues, context.roomIds);
 						case 1:
-							std::cout << "Branching by filling (" << r + 1
-									  << ", " << c + 1 << ") with value "
-									  << possibility << "." << std::endl;
+							std::cout
+								<< "Filled in a " << remaining << " at ("
+								<< r + 1 << ", " << c + 1
+								<< ") since every other value is within ripple "
+								   "range of everywhere a nearby room can put "
+								   "it."
+								<< std::endl;
 						default:
 							break;
 					}
-					const auto& resultAndBoard =
-						findSingleSolution(cellValues, roomIds, roomMap,
-										   cellsCompletedInRoom, verbosity);
-					if (resultAndBoard.first) {
-						// This is a valid completion.
-						return resultAndBoard;
+				}
+			}
+		}
+	}
+	return cellsFilled;
+}
+
+// Filters each room's remaining fillings down to the ones that agree with the
+// board, rules out any value that no remaining filling puts in a cell, and
+// fills in any cell that every remaining filling agrees on. Rooms that are
+// complete are emptied and skipped. Returns the number of cells filled in, or
+// -1 if some room has no fillings left.
+static int enforceRoomTables(Board& cellValues,
+							 std::map<int, int>& cellsCompletedInRoom,
+							 SearchContext& context, int verbosity,
+							 CellList* filledCells,
+							 EliminatedValues& eliminated,
+							 RoomSurvivors& survivors) {
+	SolverStats* stats = context.options.stats;
+	int cellsFilled = 0;
+	for (auto& roomAndFillings : survivors) {
+		// Only complete rooms are left without fillings.
+		if (roomAndFillings.second.empty()) continue;
+		int room = roomAndFillings.first;
+		const CellList& cellsInRoom = context.roomMap.at(room);
+		if (cellsCompletedInRoom[room] == cellsInRoom.size()) {
+			// Clearing keeps the storage but makes copies down the search
+			// cheaper.
+			roomAndFillings.second.clear();
+			continue;
+		}
+		const auto& table = *context.options.roomTables->fillings(room);
+		std::vector<uint64_t>& domains = context.workspace.tableDomains;
+		domains.clear();
+		for (const auto& cell : cellsInRoom) {
+			int value = cellValues[cell.first][cell.second];
+			domains.push_back(value ? 1ULL << value
+									: cellDomain(cell, cellValues, context,
+												 eliminated));
+		}
+		std::vector<int>& remaining = roomAndFillings.second;
+		size_t before = remaining.size();
+		remaining.erase(
+			std::remove_if(remaining.begin(), remaining.end(),
+						   [&table, &domains](int index) {
+							   const auto& filling = table[index];
+							   for (int i = 0; i < filling.size(); i++) {
+								   if (!(domains[i] >> filling[i] & 1)) {
+									   return true;
+								   }
+							   }
+							   return false;
+						   }),
+			remaining.end());
+		if (stats) stats->roomFillingsRejected += before - remaining.size();
+		if (remaining.empty()) {
+			return -1;
+		}
+
+		// Which values some remaining filling puts in each cell.
+		std::vector<uint64_t>& used = context.workspace.tableUsed;
+		used.assign(cellsInRoom.size(), 0);
+		for (int index : remaining) {
+			for (int i = 0; i < cellsInRoom.size(); i++) {
+				used[i] |= 1ULL << table[index][i];
+			}
+		}
+		for (int i = 0; i < cellsInRoom.size(); i++) {
+			int r, c;
+			std::tie(r, c) = cellsInRoom[i];
+			if (cellValues[r][c]) continue;
+			uint64_t removed = domains[i] & ~used[i];
+			if (removed) {
+				eliminated[r][c] |= removed;
+				if (stats) {
+					for (; removed; removed &= removed - 1) {
+						stats->roomTableEliminations++;
 					}
-					cellValues[r][c] = 0;
-					cellsCompletedInRoom[room]--;
 				}
 			}
-			// We've exhausted every possibility for this cell without finding
-			// a valid one, which means either this board is unsolvable or we
-			// branched incorrectly somewhere up the call stack.
-			return {false, {}};
+			if (used[i] & (used[i] - 1)) {
+				// More than one value left.
+				continue;
+			}
+			int value = table[remaining[0]][i];
+			cellValues[r][c] = value;
+			cellsCompletedInRoom[room]++;
+			cellsFilled++;
+			if (filledCells) filledCells->push_back(cellsInRoom[i]);
+			if (stats) stats->roomTableFills++;
+			switch (verbosity) {
+				case 2:
+					printBoard(cellValues, context.roomIds);
+				case 1:
+					std::cout << "Filled in a " << value << " at (" << r + 1
+							  << ", " << c + 1
+							  << ") since every remaining way of filling in "
+								 "its room puts it there."
+							  << std::endl;
+				default:
+					break;
+			}
 		}
 	}
-	return {false, {}};
+	return cellsFilled;
 }
 
-std::pair<bool, std::set<Board>> findAllSolutions(
-	Board /* intentional copy */ cellValues, const Board& roomIds,
-	const RoomMap& roomMap,
-	std::map<int, int> /* intentional copy */ cellsCompletedInRoom,
-	int verbosity, int* solutionCount) {
-	// First, complete the things we know for sure.
-	fillKnownCellsInBoard(cellValues, roomIds, roomMap, cellsCompletedInRoom,
-						  verbosity);
+// Fills in known cells, then, if enabled, filters room tables, applies line
+// rules and prunes rooms by matching, repeating all of them until none makes
+// progress. `survivors` is
+// only used with room tables. Returns false if the board turned out to have no
+// solutions.
+static bool propagate(Board& cellValues,
+					  std::map<int, int>& cellsCompletedInRoom,
+					  SearchContext& context, int verbosity,
+					  CellList* filledCells, EliminatedValues& eliminated,
+					  RoomSurvivors* survivors) {
+	while (true) {
+		fillKnownCellsInBoard(cellValues, context.roomIds, context.roomMap,
+							  cellsCompletedInRoom, verbosity, filledCells,
+							  &context.workspace.fill);
+		int cellsFilled = 0;
+		if (survivors) {
+			cellsFilled =
+				enforceRoomTables(cellValues, cellsCompletedInRoom, context,
+								  verbosity, filledCells, eliminated,
+								  *survivors);
+		}
+		if (cellsFilled >= 0 && context.options.lineRules) {
+			int ruled =
+				enforceLineRules(cellValues, cellsCompletedInRoom, context,
+								 verbosity, filledCells, eliminated);
+			cellsFilled = ruled < 0 ? -1 : cellsFilled + ruled;
+		}
+		if (cellsFilled >= 0 && context.options.roomMatching) {
+			int matched =
+				enforceRoomMatching(cellValues, cellsCompletedInRoom, context,
+									verbosity, filledCells, eliminated);
+			cellsFilled = matched < 0 ? -1 : cellsFilled + matched;
+		}
+		if (cellsFilled <= 0) {
+			return cellsFilled == 0;
+		}
+	}
+}
+
+// One level of lookahead for when propagation gets stuck. Each candidate value
+// of each empty cell is placed on a scratch copy of the board, propagation runs
+// from there, and the value is ruled out if that leads to a contradiction. A
+// cell with only one value left is filled in for real, followed by the usual
+// propagation, and probing goes around again. Stops once a pass rules nothing
+// out or the budget runs out. Returns false if the board turns out to have no
+// solutions at all.
+static bool probeCandidates(Board& cellValues,
+							std::map<int, int>& cellsCompletedInRoom,
+							SearchContext& context, CellList* filledCells,
+							EliminatedValues& eliminated,
+							RoomSurvivors* survivors) {
+	long long budget = context.options.probeBudget;
+	SolverStats* stats = context.options.stats;
+	bool progressed = true;
+	while (progressed && budget > 0) {
+		progressed = false;
+		if (hasContradiction(cellValues, cellsCompletedInRoom, context)) {
+			return false;
+		}
+		for (int r = 0; r < cellValues.size() && budget > 0; r++) {
+			for (int c = 0; c < cellValues[r].size() && budget > 0; c++) {
+				if (cellValues[r][c]) continue;
+				std::vector<int>& values = context.workspace.probeValues;
+				std::vector<int>& remaining = context.workspace.remaining;
+				possibleValuesForCell({r, c}, cellValues, context, &values);
+				remaining.clear();
+				for (int value : values) {
+					// Values too large to have a bit simply never get ruled
+					// out.
+					uint64_t bit = value < 64 ? 1ULL << value : 0;
+					if (eliminated[r][c] & bit) continue;
+					if (!bit || !budget) {
+						remaining.push_back(value);
+						continue;
+					}
+					budget--;
+					if (stats) stats->probes++;
+					SearchFrame& probe = context.workspace.probe;
+					probe.cellValues = cellValues;
+					probe.cellsCompletedInRoom = cellsCompletedInRoom;
+					probe.eliminated = eliminated;
+					if (survivors) probe.survivors = *survivors;
+					probe.cellValues[r][c] = value;
+					probe.cellsCompletedInRoom[context.roomIds[r][c]]++;
+					if (!propagate(probe.cellValues, probe.cellsCompletedInRoom,
+								   context, 0, nullptr, probe.eliminated,
+								   survivors ? &probe.survivors : nullptr) ||
+						hasContradiction(probe.cellValues,
+										 probe.cellsCompletedInRoom,
+										 context)) {
+						eliminated[r][c] |= bit;
+						progressed = true;
+						if (stats) stats->probeEliminations++;
+					} else {
+						remaining.push_back(value);
+					}
+				}
+				if (remaining.empty()) {
+					return false;
+				}
+				if (remaining.size() > 1) continue;
+
+				cellValues[r][c] = remaining[0];
+				cellsCompletedInRoom[context.roomIds[r][c]]++;
+				if (filledCells) filledCells->push_back({r, c});
+				if (stats) stats->probeFills++;
+				switch (context.verbosity) {
+					case 2:
+						printBoard(cellValues, context.roomIds);
+					case 1:
+						std::cout << "Filled in a " << remaining[0] << " at ("
+								  << r + 1 << ", " << c + 1
+								  << ") since every other value leads to a "
+									 "contradiction."
+								  << std::endl;
+					default:
+						break;
+				}
+				if (!propagate(cellValues, cellsCompletedInRoom, context,
+							   context.verbosity, filledCells, eliminated,
+							   survivors)) {
+					return false;
+				}
+			}
+		}
+	}
+	return !hasContradiction(cellValues, cellsCompletedInRoom, context);
+}
+
+// How many options placing `value` in the (empty) cell takes away from other
+// empty cells, for ordering values. With `footprintOnly`, just counts the empty
+// cells within range of its ripple instead.
+static int constrainingScore(const Cell& cell, int value,
+							 const Board& cellValues,
+							 const SearchContext& context,
+							 const EliminatedValues& eliminated,
+							 bool footprintOnly) {
+	int height = (int)cellValues.size(), width = (int)cellValues[0].size();
+	CellList& affected = context.workspace.affected;
+	affected.clear();
+	for (int offset = -value; offset <= value; offset++) {
+		if (!offset) continue;
+		if (cell.second + offset >= 0 && cell.second + offset < width) {
+			affected.push_back({cell.first, cell.second + offset});
+		}
+		if (cell.first + offset >= 0 && cell.first + offset < height) {
+			affected.push_back({cell.first + offset, cell.second});
+		}
+	}
+	if (!footprintOnly) {
+		// Nothing else in the room can take the value either.
+		for (const auto& roomCell :
+			 context.roomMap.at(context.roomIds[cell.first][cell.second])) {
+			if (roomCell != cell) affected.push_back(roomCell);
+		}
+		std::sort(affected.begin(), affected.end());
+		affected.erase(std::unique(affected.begin(), affected.end()),
+					   affected.end());
+	}
+	int score = 0;
+	for (const auto& other : affected) {
+		if (cellValues[other.first][other.second]) continue;
+		if (footprintOnly ||
+			cellDomain(other, cellValues, context, eliminated) >> value & 1) {
+			score++;
+		}
+	}
+	return score;
+}
+
+// Puts the node's branches in the order the options ask for.
+static void orderBranches(Branching* branching, const Board& cellValues,
+						  const EliminatedValues& eliminated,
+						  SearchContext& context) {
+	ValueOrder order = context.options.valueOrder;
+	if (order == ValueOrder::kAscending && !context.randomizeTies) {
+		return;
+	}
+	std::vector<int>& choices =
+		branching->room == -1 ? branching->values : branching->fillings;
+	if (order == ValueOrder::kRandom || order == ValueOrder::kAscending) {
+		std::shuffle(choices.begin(), choices.end(), context.random);
+		return;
+	}
+	if (context.randomizeTies) {
+		std::shuffle(choices.begin(), choices.end(), context.random);
+	}
+	bool footprintOnly = order == ValueOrder::kSmallestFootprint;
+	std::vector<std::pair<int, int>>& scored = context.workspace.scored;
+	scored.clear();
+	for (int position = 0; position < choices.size(); position++) {
+		int choice = choices[position];
+		int score = 0;
+		if (branching->room == -1) {
+			score = constrainingScore(branching->cell, choice, cellValues,
+									  context, eliminated, footprintOnly);
+		} else {
+			// Score a room filling as all of its new values together.
+			const CellList& cellsInRoom = context.roomMap.at(branching->room);
+			const auto& filling = (*context.options.roomTables->fillings(
+				branching->room))[choice];
+			for (int i = 0; i < cellsInRoom.size(); i++) {
+				const Cell& cell = cellsInRoom[i];
+				if (!cellValues[cell.first][cell.second]) {
+					score += constrainingScore(cell, filling[i], cellValues,
+											   context, eliminated,
+											   footprintOnly);
+				}
+			}
+		}
+		scored.push_back({score, position});
+	}
+	// Ties stay in their current order, as with a stable sort, which would
+	// allocate.
+	std::sort(scored.begin(), scored.end());
+	std::vector<int>& ordered = context.workspace.ordered;
+	ordered.clear();
+	for (const auto& scoreAndPosition : scored) {
+		ordered.push_back(choices[scoreAndPosition.second]);
+	}
+	std::copy(ordered.begin(), ordered.end(), choices.begin());
+}
+
+// Same as validateCompleteBoard, but without rechecking that the rooms are
+// contiguous (which allocates) and without looking any further than the first
+// empty cell, since most boards the search sees aren't complete.
+static bool isSolved(const Board& cellValues, const SearchContext& context) {
+	for (const auto& row : cellValues) {
+		for (int value : row) {
+			if (!value) return false;
+		}
+	}
+	if (!context.roomsValid) {
+		return false;
+	}
+	bool solved;
+	if (isSolvedFixedSize(cellValues, context.roomMap, &solved)) {
+		return solved;
+	}
+	for (int r = 0; r < cellValues.size(); r++) {
+		for (int c = 0; c < cellValues[r].size(); c++) {
+			int value = cellValues[r][c];
+			if (!checkRow({r, c}, value, cellValues) ||
+				!checkColumn({r, c}, value, cellValues) ||
+				!checkRoom({r, c}, context.roomMap.at(context.roomIds[r][c]),
+						   value, cellValues)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// The first half of every search node: completes the things we know for sure
+// about the frame's board, keeping its hash in step if there's a transposition
+// table. Returns true if that solved the board outright. Otherwise, decides how
+// to branch, which may be no way at all. The hash as it was before anything was
+// filled in is left in `entryHash`. With room tables, the room fillings that
+// survive are left in `survivors`, starting from `parentSurvivors` (or every
+// filling, if null). `depth` is only for tracing.
+static bool expandNode(SearchFrame& frame, const RoomSurvivors* parentSurvivors,
+					   int depth, SearchContext& context) {
+	Board& cellValues = frame.cellValues;
+	std::map<int, int>& cellsCompletedInRoom = frame.cellsCompletedInRoom;
+	uint64_t& hash = frame.hash;
+	RoomSurvivors* survivors = &frame.survivors;
+	Branching* branching = &frame.branching;
+	context.nodes++;
+	if (context.options.stats) context.options.stats->nodes++;
+	frame.entryHash = hash;
+	CellList& filledCells = frame.filledCells;
+	filledCells.clear();
+	CellList* tracked =
+		context.options.transpositionTable ? &filledCells : nullptr;
+	EliminatedValues& eliminated = frame.eliminated;
+	eliminated.resize(cellValues.size());
+	for (auto& row : eliminated) {
+		row.assign(cellValues[0].size(), 0);
+	}
+	const RoomTables* roomTables = context.options.roomTables;
+	if (roomTables && parentSurvivors) {
+		*survivors = *parentSurvivors;
+	} else if (roomTables) {
+		*survivors = context.workspace.allSurvivors;
+	}
+	int64_t traceStart = 0;
+	int knownBefore = 0;
+	if (context.trace) {
+		traceStart = context.options.tracer->now();
+		knownBefore = countKnownCells(cellValues);
+	}
+	bool solvable;
+	{
+		PerfScope scope(PerfPhase::kPropagation, context.options.stats);
+		solvable = propagate(cellValues, cellsCompletedInRoom, context,
+							 context.verbosity, tracked, eliminated,
+							 roomTables ? survivors : nullptr);
+		if (solvable && context.options.probeBudget > 0 &&
+			!isSolved(cellValues, context)) {
+			solvable = probeCandidates(cellValues, cellsCompletedInRoom,
+									   context, tracked, eliminated,
+									   roomTables ? survivors : nullptr);
+		}
+	}
+	if (context.trace) {
+		traceEvent(context, TraceEventKind::kPropagate, depth, traceStart,
+				   context.options.tracer->now() - traceStart,
+				   countKnownCells(cellValues) - knownBefore);
+	}
+	for (const auto& cell : filledCells) {
+		hash ^= context.options.transpositionTable->cellKey(
+			cell.first, cell.second, cellValues[cell.first][cell.second]);
+	}
+	branching->values.clear();
+	branching->room = -1;
+	branching->fillings.clear();
+	if (!solvable) {
+		// Propagation proved there's nothing down here, so don't branch at
+		// all.
+		return false;
+	}
 
 	// At this point, we're either done the puzzle or need to branch.
-	if (validateCompleteBoard(cellValues, roomIds, roomMap)) {
-		if (solutionCount) {
-			std::cout << "Found " << ++*solutionCount << " solution"
-					  << (*solutionCount == 1 ? "" : "s") << " so far."
-					  << std::endl;
+	bool solved;
+	{
+		PerfScope scope(PerfPhase::kValidation, context.options.stats);
+		solved = isSolved(cellValues, context);
+	}
+	if (solved) {
+		if (context.trace) {
+			traceEvent(context, TraceEventKind::kSolution, depth,
+					   context.options.tracer->now());
 		}
-		return {true, {cellValues}};
+		return true;
 	}
 
+	PerfScope scope(PerfPhase::kBranching, context.options.stats);
 	// Now, we need to make a choice. Find the first empty cell and fill it with
-	// its first possibility, then recurse. If that returns a valid solution,
-	// return that. Otherwise, try the next value until one is found or all are
-	// exhausted. This is indeed DFS, not BFS, but it is guaranteed to
-	// eventually terminate for any input due to the nature of the puzzle.
-	switch (verbosity) {
+	// each of its possibilities in turn, recursing each time. This is indeed
+	// DFS, not BFS, but it is guaranteed to eventually terminate for any input
+	// due to the nature of the puzzle.
+	switch (context.verbosity) {
 		case 2:
 		case 1:
 			std::cout << "Unable to fill in any more cells with certainty. "
@@ -137,65 +1011,710 @@ std::pair<bool, std::set<Board>> findAllSolutions(
 		default:
 			break;
 	}
-
-	std::set<Board> branchCompletions;
+	if (roomTables && context.options.roomBranching) {
+		// Fill in the most constrained room all at once instead.
+		for (const auto& roomAndFillings : *survivors) {
+			if (roomAndFillings.second.empty() ||
+				cellsCompletedInRoom[roomAndFillings.first] ==
+				context.roomMap.at(roomAndFillings.first).size()) {
+				continue;
+			}
+			if (branching->room == -1 ||
+				roomAndFillings.second.size() < branching->fillings.size()) {
+				branching->room = roomAndFillings.first;
+				branching->fillings = roomAndFillings.second;
+			}
+		}
+		if (branching->room != -1) {
+			orderBranches(branching, cellValues, eliminated, context);
+			return false;
+		}
+	}
 	for (int r = 0; r < cellValues.size(); r++) {
 		for (int c = 0; c < cellValues[r].size(); c++) {
-			if (cellValues[r][c]) {
-				continue;
+			if (!cellValues[r][c]) {
+				branching->cell = {r, c};
+				possibleValuesForCell(branching->cell, cellValues, context,
+									  &branching->values);
+				// No point branching into values already ruled out.
+				uint64_t ruledOut = eliminated[r][c];
+				branching->values.erase(
+					std::remove_if(branching->values.begin(),
+								   branching->values.end(),
+								   [ruledOut](int value) {
+									   return value < 64 &&
+											  (ruledOut >> value & 1);
+								   }),
+					branching->values.end());
+				orderBranches(branching, cellValues, eliminated, context);
+				return false;
 			}
-			// Now determine which values are possible here.
-			int room = roomIds[r][c];
-			std::vector<bool> usedNumber(roomMap.at(room).size(), false);
-			for (const auto& cell : roomMap.at(room)) {
-				int value = cellValues[cell.first][cell.second];
-				if (value) {
-					usedNumber[value - 1] = true;
+		}
+	}
+	return false;
+}
+
+// Fills in the `index`th choice of `branching` on a fresh copy of the board for
+// a child node, keeping the child's hash in step.
+static void branchInto(const Branching& branching, int index,
+					   Board& cellValues,
+					   std::map<int, int>& cellsCompletedInRoom, uint64_t& hash,
+					   const SearchContext& context) {
+	if (context.options.stats) context.options.stats->branches++;
+	// Points into the branching or the room tables rather than copying, so
+	// that branching doesn't allocate.
+	const Cell* cells = &branching.cell;
+	const int* values = nullptr;
+	size_t count = 1;
+	if (branching.room == -1) {
+		values = &branching.values[index];
+	} else {
+		const CellList& roomCells = context.roomMap.at(branching.room);
+		cells = roomCells.data();
+		values = (*context.options.roomTables->fillings(
+					 branching.room))[branching.fillings[index]]
+					 .data();
+		count = roomCells.size();
+	}
+	for (int i = 0; i < count; i++) {
+		int r, c;
+		std::tie(r, c) = cells[i];
+		if (cellValues[r][c]) continue;
+		cellValues[r][c] = values[i];
+		cellsCompletedInRoom[context.roomIds[r][c]]++;
+		if (context.options.transpositionTable) {
+			hash ^=
+				context.options.transpositionTable->cellKey(r, c, values[i]);
+		}
+	}
+	switch (context.verbosity) {
+		case 2:
+			printBoard(cellValues, context.roomIds);
+		case 1:
+			if (branching.room == -1) {
+				std::cout << "Branching by filling (" << cells[0].first + 1
+						  << ", " << cells[0].second + 1 << ") with value "
+						  << values[0] << "." << std::endl;
+			} else {
+				std::cout << "Branching by filling the room containing ("
+						  << cells[0].first + 1 << ", " << cells[0].second + 1
+						  << ") with values";
+				for (int i = 0; i < count; i++) {
+					std::cout << " " << values[i];
 				}
+				std::cout << "." << std::endl;
 			}
-			std::vector<int> possibleValues;
-			for (int i = 0; i < usedNumber.size(); i++) {
-				if (!usedNumber[i]) {
-					possibleValues.push_back(i + 1);
+		default:
+			break;
+	}
+}
+
+// Returns true, setting `aborted`, if the search has to stop now because the
+// current attempt has used up `nodeLimit`, or because a budget has run out or
+// the search was cancelled, which also sets `status`.
+static bool shouldStop(SearchContext& context) {
+	if (context.aborted) {
+		return true;
+	}
+	context.status = checkBudgets(context.options, context.nodes);
+	if (context.status != SolveStatus::kFinished ||
+		(context.nodeLimit > 0 && context.nodes >= context.nodeLimit)) {
+		context.aborted = true;
+	}
+	return context.aborted;
+}
+
+// Looks a board up in the transposition table, if there is one.
+static bool lookUpNode(uint64_t hash, const SearchContext& context,
+					   long long* solutions) {
+	return context.options.transpositionTable &&
+		   context.options.transpositionTable->probe(hash, solutions,
+													 context.options.stats);
+}
+
+// Records the number of solutions below a node, if there's a transposition
+// table. The result is stored under both the board the node started with and
+// the board after filling in known cells: the former lets a repeat skip even
+// the filling in, while the latter is reached by more branch orders.
+// `nodesBefore` is the node count when the node was expanded.
+static void recordNode(uint64_t entryHash, uint64_t hash, long long solutions,
+					   long long nodesBefore, const SearchContext& context) {
+	if (solutions == 0 && context.options.stats) {
+		context.options.stats->deadEnds++;
+	}
+	TranspositionTable* table = context.options.transpositionTable;
+	if (table) {
+		long long nodes = context.nodes - nodesBefore;
+		table->store(hash, solutions, nodes, context.options.stats);
+		if (entryHash != hash) {
+			table->store(entryHash, solutions, nodes, context.options.stats);
+		}
+	}
+}
+
+// Sets up `root` as the frame for the board the search starts from.
+static void setUpRoot(SearchFrame& root, const Board& cellValues,
+					  const std::map<int, int>& cellsCompletedInRoom,
+					  const SearchContext& context) {
+	const SolverOptions& options = context.options;
+	root.cellValues = cellValues;
+	root.cellsCompletedInRoom = cellsCompletedInRoom;
+	// Give every room an entry up front, so that copies of the map down the
+	// search all have the same shape and never need to add one.
+	for (const auto& roomAndCells : context.roomMap) {
+		root.cellsCompletedInRoom[roomAndCells.first];
+	}
+	root.hash = options.transpositionTable
+					? options.transpositionTable->hashBoard(cellValues)
+					: 0;
+	root.expanded = false;
+	root.resumed = false;
+}
+
+// Sets up the frame at `depth` as branch `index` of `parent`, reusing whatever
+// it already has allocated.
+static void pushBranch(const SearchFrame& parent, int index, int depth,
+					   SearchContext& context) {
+	SearchFrame& child = context.workspace.frame(depth);
+	if (context.trace) traceBranch(context, parent.branching, index, depth);
+	PerfScope scope(PerfPhase::kBranching, context.options.stats);
+	child.cellValues = parent.cellValues;
+	child.cellsCompletedInRoom = parent.cellsCompletedInRoom;
+	child.hash = parent.hash;
+	branchInto(parent.branching, index, child.cellValues,
+			   child.cellsCompletedInRoom, child.hash, context);
+	child.expanded = false;
+	child.resumed = false;
+}
+
+// The recursive half of findSingleSolution, searching below the board in
+// frame `depth` of the workspace.
+static bool searchSingle(int depth, SearchContext& context, Board* solution) {
+	std::vector<SearchFrame>& frames = context.workspace.frames;
+	// The frames were reserved up front, so this stays valid below.
+	SearchFrame& frame = frames[depth];
+	long long known;
+	if (lookUpNode(frame.hash, context, &known) && known == 0) {
+		return false;
+	}
+	if (shouldStop(context)) {
+		return false;
+	}
+	long long nodesBefore = context.nodes;
+	if (expandNode(frame, depth ? &frames[depth - 1].survivors : nullptr,
+				   depth, context)) {
+		*solution = frame.cellValues;
+		return true;
+	}
+	if (frame.hash != frame.entryHash &&
+		lookUpNode(frame.hash, context, &known) && known == 0) {
+		return false;
+	}
+	for (int i = 0; i < frame.branching.size(); i++) {
+		// Each branch gets its own copy to fill in, since propagation below it
+		// modifies more than just this cell.
+		pushBranch(frame, i, depth + 1, context);
+		if (searchSingle(depth + 1, context, solution)) {
+			// This is a valid completion.
+			return true;
+		}
+		traceBacktrack(context, depth + 1);
+		if (context.aborted) {
+			// This board isn't necessarily a dead end, so don't record it.
+			return false;
+		}
+	}
+	// We've exhausted every possibility for this cell without finding a valid
+	// one, which means either this board is unsolvable or we branched
+	// incorrectly somewhere up the call stack.
+	recordNode(frame.entryHash, frame.hash, 0, nodesBefore, context);
+	return false;
+}
+
+// The searches below all work in `workspace` and take whether the rooms are
+// valid from their caller, so that a Solver only has to work either out once.
+static std::pair<bool, Board> runSingle(
+	const Board& cellValues, const Board& roomIds, const RoomMap& roomMap,
+	bool roomsValid, const std::map<int, int>& cellsCompletedInRoom,
+	int verbosity, const SolverOptions& options, SearchWorkspace& workspace) {
+	if (options.engine == SearchEngine::kLearning) {
+		LearningSolver solver(cellValues, roomIds, roomMap, verbosity,
+							  options);
+		Board solution;
+		bool solved = solver.solve(&solution);
+		if (options.status) *options.status = solver.status();
+		return {solved, solution};
+	}
+	SearchContext context = {roomIds, roomMap, verbosity, options, workspace,
+							 0};
+	context.roomsValid = roomsValid;
+	context.trace = options.tracer ? options.tracer->threadBuffer() : nullptr;
+	context.random.seed(options.seed);
+	workspace.reserveFor(cellValues, roomMap, options.roomTables);
+	Board solution;
+	for (int restart = 0;; restart++) {
+		long long budget = restartNodeBudget(options, restart);
+		context.nodeLimit = budget > 0 ? context.nodes + budget : 0;
+		context.aborted = false;
+		context.randomizeTies = restart > 0;
+		// Each attempt starts from scratch.
+		setUpRoot(workspace.frame(0), cellValues, cellsCompletedInRoom,
+				  context);
+		bool solved = searchSingle(0, context, &solution);
+		if (!context.aborted || context.status != SolveStatus::kFinished) {
+			if (options.status) *options.status = context.status;
+			return {solved, solution};
+		}
+		if (options.stats) options.stats->restarts++;
+		switch (verbosity) {
+			case 2:
+			case 1:
+				std::cout << "Giving up after " << budget
+						  << " search nodes and starting over." << std::endl;
+			default:
+				break;
+		}
+	}
+}
+
+std::pair<bool, Board> findSingleSolution(
+	const Board& cellValues, const Board& roomIds, const RoomMap& roomMap,
+	const std::map<int, int>& cellsCompletedInRoom, int verbosity,
+	const SolverOptions& options) {
+	SearchWorkspace workspace;
+	return runSingle(cellValues, roomIds, roomMap,
+					 validateRooms(roomIds, roomMap), cellsCompletedInRoom,
+					 verbosity, options, workspace);
+}
+
+// Saves frames 0 to `top` (-1 for none), where `top` is about to start branch
+// `next`, to the options' checkpoint file.
+static void saveCheckpoint(const std::vector<SearchFrame>& stack, int top,
+						   const Board& start, long long visited,
+						   const SearchContext& context) {
+	SearchCheckpoint checkpoint;
+	checkpoint.board = start;
+	checkpoint.roomIds = context.roomIds;
+	checkpoint.visited = visited;
+	for (int depth = 0; depth <= top; depth++) {
+		const Branching& branching = stack[depth].branching;
+		CheckpointFrame frame;
+		frame.cell = branching.cell;
+		frame.values = branching.values;
+		frame.room = branching.room;
+		frame.fillings = branching.fillings;
+		frame.next = stack[depth].next;
+		checkpoint.frames.push_back(frame);
+	}
+	if (!writeCheckpoint(context.options.checkpointPath, checkpoint)) {
+		std::cerr << "Failed to write a checkpoint to "
+				  << context.options.checkpointPath << "." << std::endl;
+		return;
+	}
+	switch (context.verbosity) {
+		case 2:
+		case 1:
+			std::cout << "Saved a checkpoint " << top + 1
+					  << " branches deep after " << visited << " solutions."
+					  << std::endl;
+		default:
+			break;
+	}
+}
+
+// Rebuilds the search stack saved in `checkpoint` on top of the root board in
+// the workspace's first frame by replaying its choices, and sets `*depth` to
+// the frame to carry on from. Returns false if the checkpoint doesn't fit the
+// board.
+static bool resumeFromCheckpoint(const SearchCheckpoint& checkpoint,
+								 int* depth, SearchContext& context) {
+	std::vector<SearchFrame>& stack = context.workspace.frames;
+	const Board& root = stack[0].cellValues;
+	*depth = 0;
+	if (checkpoint.frames.size() >
+		root.size() * root[0].size() - countKnownCells(root)) {
+		// Deeper than any real search could have got.
+		return false;
+	}
+	for (int d = 0; d < checkpoint.frames.size(); d++) {
+		const CheckpointFrame& saved = checkpoint.frames[d];
+		SearchFrame& frame = stack[d];
+		if (expandNode(frame, d ? &stack[d - 1].survivors : nullptr, d,
+					   context)) {
+			return false;
+		}
+		Branching& branching = frame.branching;
+		if (saved.room == -1) {
+			if (frame.cellValues[saved.cell.first][saved.cell.second]) {
+				return false;
+			}
+		} else if (!context.options.roomTables ||
+				   !context.options.roomTables->fillings(saved.room)) {
+			return false;
+		} else {
+			size_t fillings =
+				context.options.roomTables->fillings(saved.room)->size();
+			for (int filling : saved.fillings) {
+				if (filling < 0 || filling >= fillings) return false;
+			}
+		}
+		branching.cell = saved.cell;
+		branching.values = saved.values;
+		branching.room = saved.room;
+		branching.fillings = saved.fillings;
+		bool last = d + 1 == checkpoint.frames.size();
+		if (saved.next < (last ? 0 : 1) || saved.next > branching.size()) {
+			return false;
+		}
+		frame.expanded = true;
+		frame.next = saved.next;
+		frame.resumed = true;
+		*depth = d;
+		if (!last) {
+			pushBranch(frame, frame.next - 1, d + 1, context);
+		}
+	}
+	return true;
+}
+
+// The search behind enumerateSolutions. Visits every solution below the board
+// in frame `depth` of the workspace (with every frame below it already
+// expanded), adding them to `visited`. Keeps its own stack rather than
+// recursing, so that depth is only limited by memory and the search can be
+// saved to a checkpoint file at any point. Returns false once `onSolution` has
+// asked to stop, or if the search was aborted.
+static bool visitSolutions(
+	int depth, const Board& start, SearchContext& context,
+	const std::function<bool(const Board&)>& onSolution, long long* visited) {
+	std::vector<SearchFrame>& stack = context.workspace.frames;
+	const SolverOptions& options = context.options;
+	bool checkpointing = !options.checkpointPath.empty();
+	auto interval = std::chrono::duration_cast<
+		std::chrono::steady_clock::duration>(
+		std::chrono::duration<double>(options.checkpointSeconds));
+	auto nextCheckpoint = std::chrono::steady_clock::now() + interval;
+	while (depth >= 0) {
+		SearchFrame& frame = stack[depth];
+		long long known;
+		if (!frame.expanded) {
+			if (lookUpNode(frame.hash, context, &known) && known == 0) {
+				traceBacktrack(context, depth);
+				depth--;
+				continue;
+			}
+			if (shouldStop(context)) {
+				// Save the parent as about to start this branch again.
+				if (checkpointing) {
+					if (depth) stack[depth - 1].next--;
+					saveCheckpoint(stack, depth - 1, start, *visited, context);
 				}
+				return false;
 			}
-			for (int possibility : possibleValues) {
-				if (checkRow({r, c}, possibility, cellValues) &&
-					checkColumn({r, c}, possibility, cellValues)) {
-					// Now we attempt this completion, and undo it if it doesn't
-					// work.
-					cellValues[r][c] = possibility;
-					cellsCompletedInRoom[room]++;
-					switch (verbosity) {
-						case 2:
-							printBoard(cellValues, roomIds);
-						case 1:
-							std::cout << "Branching by filling (" << r + 1
-									  << ", " << c + 1 << ") with value "
-									  << possibility << "." << std::endl;
-						default:
-							break;
-					}
-					const auto& resultAndBoards = findAllSolutions(
-						cellValues, roomIds, roomMap, cellsCompletedInRoom,
-						verbosity, solutionCount);
-					if (resultAndBoards.first) {
-						// We have valid completions.
-						branchCompletions.insert(resultAndBoards.second.begin(),
-												 resultAndBoards.second.end());
+			frame.expanded = true;
+			frame.nodesBefore = context.nodes;
+			if (expandNode(frame,
+						   depth ? &stack[depth - 1].survivors : nullptr, depth,
+						   context)) {
+				++*visited;
+				bool carryOn;
+				{
+					PerfScope scope(PerfPhase::kAggregation, options.stats);
+					carryOn = onSolution(frame.cellValues);
+				}
+				if (!carryOn) {
+					// This solution has been visited, so the parent is about
+					// to start its next branch.
+					if (checkpointing) {
+						saveCheckpoint(stack, depth - 1, start, *visited,
+									   context);
 					}
-					cellValues[r][c] = 0;
-					cellsCompletedInRoom[room]--;
+					return false;
 				}
+				traceBacktrack(context, depth);
+				depth--;
+				continue;
+			}
+			if (frame.hash != frame.entryHash &&
+				lookUpNode(frame.hash, context, &known) && known == 0) {
+				traceBacktrack(context, depth);
+				depth--;
+				continue;
+			}
+			frame.next = 0;
+			frame.visitedBefore = *visited;
+		}
+		if (frame.next == frame.branching.size()) {
+			// We've exhausted every possibility for this cell, so everything
+			// below this point has been visited.
+			if (!frame.resumed) {
+				recordNode(frame.entryHash, frame.hash,
+						   *visited - frame.visitedBefore, frame.nodesBefore,
+						   context);
+			}
+			traceBacktrack(context, depth);
+			depth--;
+			continue;
+		}
+		if (checkpointing &&
+			std::chrono::steady_clock::now() >= nextCheckpoint) {
+			saveCheckpoint(stack, depth, start, *visited, context);
+			nextCheckpoint = std::chrono::steady_clock::now() + interval;
+		}
+		// Every branch fills in at least one cell, so the stack was reserved
+		// deep enough that this never moves the frames.
+		pushBranch(frame, frame.next++, depth + 1, context);
+		depth++;
+	}
+	return true;
+}
+
+static long long runEnumerate(
+	const Board& cellValues, const Board& roomIds, const RoomMap& roomMap,
+	bool roomsValid, const std::map<int, int>& cellsCompletedInRoom,
+	int verbosity,
+	const std::function<bool(const Board&)>& onSolution,
+	const SolverOptions& options, SearchWorkspace& workspace) {
+	if (options.engine == SearchEngine::kLearning) {
+		// Each solution found is ruled out before looking for the next.
+		LearningSolver solver(cellValues, roomIds, roomMap, verbosity,
+							  options);
+		long long visited = 0;
+		Board solution;
+		while (solver.solve(&solution)) {
+			visited++;
+			if (!onSolution(solution)) break;
+			solver.blockSolution(solution);
+		}
+		if (options.status) *options.status = solver.status();
+		return visited;
+	}
+	SearchContext context = {roomIds, roomMap, verbosity, options, workspace,
+							 0};
+	context.roomsValid = roomsValid;
+	context.trace = options.tracer ? options.tracer->threadBuffer() : nullptr;
+	context.random.seed(options.seed);
+	workspace.reserveFor(cellValues, roomMap, options.roomTables);
+	setUpRoot(workspace.frame(0), cellValues, cellsCompletedInRoom, context);
+
+	long long visited = 0;
+	int depth = 0;
+	SearchCheckpoint checkpoint;
+	if (!options.checkpointPath.empty() &&
+		readCheckpoint(options.checkpointPath, &checkpoint)) {
+		if (checkpoint.board == cellValues && checkpoint.roomIds == roomIds &&
+			resumeFromCheckpoint(checkpoint, &depth, context)) {
+			visited = checkpoint.visited;
+			switch (verbosity) {
+				case 2:
+				case 1:
+					std::cout << "Resuming from a checkpoint "
+							  << checkpoint.frames.size()
+							  << " branches deep after " << visited
+							  << " solutions." << std::endl;
+				default:
+					break;
 			}
-			// We've exhausted every possibility for this cell without finding
-			// a valid one, which means either this board is unsolvable or we
-			// branched incorrectly somewhere up the call stack.
-			goto done;  // Java's `break label` functionality would be nice.
+		} else {
+			std::cerr << "Ignoring checkpoint " << options.checkpointPath
+					  << ", which doesn't match this board." << std::endl;
+			setUpRoot(workspace.frame(0), cellValues, cellsCompletedInRoom,
+					  context);
+			depth = 0;
 		}
 	}
-done:
-	return {branchCompletions.size() > 0, branchCompletions};
+	if (visitSolutions(depth, cellValues, context, onSolution, &visited) &&
+		!options.checkpointPath.empty()) {
+		// Finished, so there's nothing left to resume.
+		std::remove(options.checkpointPath.c_str());
+	}
+	if (options.status) *options.status = context.status;
+	return visited;
+}
+
+long long enumerateSolutions(
+	const Board& cellValues, const Board& roomIds, const RoomMap& roomMap,
+	const std::map<int, int>& cellsCompletedInRoom, int verbosity,
+	const std::function<bool(const Board&)>& onSolution,
+	const SolverOptions& options) {
+	SearchWorkspace workspace;
+	return runEnumerate(cellValues, roomIds, roomMap,
+						validateRooms(roomIds, roomMap), cellsCompletedInRoom,
+						verbosity, onSolution, options, workspace);
+}
+
+static std::pair<bool, std::set<Board>> runAll(
+	const Board& cellValues, const Board& roomIds, const RoomMap& roomMap,
+	bool roomsValid, const std::map<int, int>& cellsCompletedInRoom,
+	int verbosity, int* solutionCount, const SolverOptions& options,
+	SearchWorkspace& workspace) {
+	std::set<Board> solutions;
+	// Roughly what each solution costs in the set: the board's rows and the
+	// tree node holding it.
+	size_t solutionBytes = sizeof(Board) + 4 * sizeof(void*) +
+						   cellValues.size() * (sizeof(std::vector<int>) +
+												cellValues[0].size() *
+													sizeof(int));
+	bool outOfMemory = false;
+	runEnumerate(
+		cellValues, roomIds, roomMap, roomsValid, cellsCompletedInRoom,
+		verbosity,
+		[&](const Board& solution) {
+			solutions.insert(solution);
+			if (solutionCount) {
+				std::cout << "Found " << ++*solutionCount << " solution"
+						  << (*solutionCount == 1 ? "" : "s") << " so far.\n";
+			}
+			outOfMemory =
+				options.memoryBudget > 0 &&
+				solutions.size() * solutionBytes > options.memoryBudget;
+			return !outOfMemory;
+		},
+		options, workspace);
+	if (outOfMemory && options.status) {
+		*options.status = SolveStatus::kOutOfMemory;
+	}
+	return {solutions.size() > 0, solutions};
+}
+
+std::pair<bool, std::set<Board>> findAllSolutions(
+	const Board& cellValues, const Board& roomIds, const RoomMap& roomMap,
+	const std::map<int, int>& cellsCompletedInRoom, int verbosity,
+	int* solutionCount, const SolverOptions& options) {
+	SearchWorkspace workspace;
+	return runAll(cellValues, roomIds, roomMap, validateRooms(roomIds, roomMap),
+				  cellsCompletedInRoom, verbosity, solutionCount, options,
+				  workspace);
+}
+
+// The recursive half of countSolutions, counting below the board in frame
+// `depth` of the workspace. Stops early once the count reaches `limit`, if it's
+// positive.
+static long long countBelow(int depth, SearchContext& context,
+							long long limit) {
+	std::vector<SearchFrame>& frames = context.workspace.frames;
+	SearchFrame& frame = frames[depth];
+	long long known;
+	if (lookUpNode(frame.hash, context, &known)) {
+		return known;
+	}
+	if (shouldStop(context)) {
+		return 0;
+	}
+	long long nodesBefore = context.nodes;
+	if (expandNode(frame, depth ? &frames[depth - 1].survivors : nullptr,
+				   depth, context)) {
+		return 1;
+	}
+	if (frame.hash != frame.entryHash &&
+		lookUpNode(frame.hash, context, &known)) {
+		return known;
+	}
+	long long count = 0;
+	for (int i = 0; i < frame.branching.size(); i++) {
+		pushBranch(frame, i, depth + 1, context);
+		count += countBelow(depth + 1, context, limit > 0 ? limit - count : 0);
+		traceBacktrack(context, depth + 1);
+		if ((limit > 0 && count >= limit) || context.aborted) {
+			// Only a lower bound, so it can't go in the table.
+			return count;
+		}
+	}
+	recordNode(frame.entryHash, frame.hash, count, nodesBefore, context);
+	return count;
+}
+
+static long long runCount(const Board& cellValues, const Board& roomIds,
+						  const RoomMap& roomMap, bool roomsValid,
+						  const std::map<int, int>& cellsCompletedInRoom,
+						  int verbosity, long long limit,
+						  const SolverOptions& options,
+						  SearchWorkspace& workspace) {
+	if (options.engine == SearchEngine::kLearning) {
+		return runEnumerate(
+			cellValues, roomIds, roomMap, roomsValid, cellsCompletedInRoom,
+			verbosity,
+			[&limit](const Board&) { return --limit != 0; }, options,
+			workspace);
+	}
+	SearchContext context = {roomIds, roomMap, verbosity, options, workspace,
+							 0};
+	context.roomsValid = roomsValid;
+	context.trace = options.tracer ? options.tracer->threadBuffer() : nullptr;
+	context.random.seed(options.seed);
+	workspace.reserveFor(cellValues, roomMap, options.roomTables);
+	setUpRoot(workspace.frame(0), cellValues, cellsCompletedInRoom, context);
+	long long count = countBelow(0, context, limit);
+	if (options.status) *options.status = context.status;
+	return limit > 0 ? std::min(count, limit) : count;
+}
+
+long long countSolutions(const Board& cellValues, const Board& roomIds,
+						 const RoomMap& roomMap,
+						 const std::map<int, int>& cellsCompletedInRoom,
+						 int verbosity, long long limit,
+						 const SolverOptions& options) {
+	SearchWorkspace workspace;
+	return runCount(cellValues, roomIds, roomMap,
+					validateRooms(roomIds, roomMap), cellsCompletedInRoom,
+					verbosity, limit, options, workspace);
+}
+
+Solver::Solver(const Board& roomIds)
+	: roomIds(roomIds), workspace(new SearchWorkspace()) {
+	for (int r = 0; r < roomIds.size(); r++) {
+		for (int c = 0; c < roomIds[r].size(); c++) {
+			rooms[roomIds[r][c]].push_back({r, c});
+			completed[roomIds[r][c]] = 0;
+		}
+	}
+	roomsValid = validateRooms(roomIds, rooms);
+}
+
+// Out of line, since SearchWorkspace is only complete in this file.
+Solver::~Solver() {}
+
+void Solver::countCompleted(const Board& cellValues) {
+	// Every room stays in the map, so that its nodes are reused.
+	for (auto& roomAndCount : completed) {
+		roomAndCount.second = 0;
+	}
+	for (int r = 0; r < cellValues.size(); r++) {
+		for (int c = 0; c < cellValues[r].size(); c++) {
+			if (cellValues[r][c]) completed[roomIds[r][c]]++;
+		}
+	}
+}
+
+std::pair<bool, Board> Solver::findSingleSolution(
+	const Board& cellValues, int verbosity, const SolverOptions& options) {
+	countCompleted(cellValues);
+	return runSingle(cellValues, roomIds, rooms, roomsValid, completed,
+					 verbosity, options, *workspace);
+}
+
+long long Solver::enumerateSolutions(
+	const Board& cellValues, int verbosity,
+	const std::function<bool(const Board&)>& onSolution,
+	const SolverOptions& options) {
+	countCompleted(cellValues);
+	return runEnumerate(cellValues, roomIds, rooms, roomsValid, completed,
+						verbosity, onSolution, options, *workspace);
+}
+
+std::pair<bool, std::set<Board>> Solver::findAllSolutions(
+	const Board& cellValues, int verbosity, int* solutionCount,
+	const SolverOptions& options) {
+	countCompleted(cellValues);
+	return runAll(cellValues, roomIds, rooms, roomsValid, completed,
+				  verbosity, solutionCount, options, *workspace);
+}
+
+long long Solver::countSolutions(const Board& cellValues, int verbosity,
+								 long long limit,
+								 const SolverOptions& options) {
+	countCompleted(cellValues);
+	return runCount(cellValues, roomIds, rooms, roomsValid, completed,
+					verbosity, limit, options, *workspace);
 }
 
 Board aggregateBoards(const std::set<Board>& boards) {
@@ -214,7 +1733,10 @@ Board aggregateBoards(const std::set<Board>& boards) {
 }
 
 int fillKnownCellsInRoom(Board& cellValues, const Board& roomIds, int room,
-						 const CellList& cellsInRoom, int verbosity) {
+						 const CellList& cellsInRoom, int verbosity,
+						 CellList* filledCells, FillScratch* scratch) {
+	FillScratch local;
+	FillScratch& space = scratch ? *scratch : local;
 	int cellsFilled = 0;
 	bool modifiedRoom;
 	do {
@@ -222,8 +1744,10 @@ int fillKnownCellsInRoom(Board& cellValues, const Board& roomIds, int room,
 		// First, we need to figure out which numbers haven't been used and
 		// which cells are empty.
 		int r, c;
-		std::vector<bool> usedNumber(cellsInRoom.size(), false);
-		CellList emptyCells;
+		std::vector<char>& usedNumber = space.usedNumber;
+		usedNumber.assign(cellsInRoom.size(), false);
+		CellList& emptyCells = space.emptyCells;
+		emptyCells.clear();
 		for (const auto& cell : cellsInRoom) {
 			std::tie(r, c) = cell;
 			if (cellValues[r][c]) {
@@ -235,7 +1759,8 @@ int fillKnownCellsInRoom(Board& cellValues, const Board& roomIds, int room,
 
 		// If we have any empty cells, start looking through their combinations
 		// of possibilities.
-		std::vector<int> possibleValues;
+		std::vector<int>& possibleValues = space.possibleValues;
+		possibleValues.clear();
 		for (int i = 0; i < usedNumber.size(); i++) {
 			if (!usedNumber[i]) {
 				possibleValues.push_back(i + 1);
@@ -263,6 +1788,7 @@ int fillKnownCellsInRoom(Board& cellValues, const Board& roomIds, int room,
 			if (validPossibility) {
 				cellValues[r][c] = validPossibility;
 				cellsFilled++;
+				if (filledCells) filledCells->push_back(cell);
 				modifiedRoom = true;
 				switch (verbosity) {
 					case 2:
@@ -310,6 +1836,7 @@ int fillKnownCellsInRoom(Board& cellValues, const Board& roomIds, int room,
 			if (r != -1) {
 				cellValues[r][c] = possibleValue;
 				cellsFilled++;
+				if (filledCells) filledCells->push_back({r, c});
 				modifiedRoom = true;
 				switch (verbosity) {
 					case 2:
@@ -338,7 +1865,14 @@ int fillKnownCellsInRoom(Board& cellValues, const Board& roomIds, int room,
 void fillKnownCellsInBoard(Board& cellValues, const Board& roomIds,
 						   const RoomMap& roomMap,
 						   std::map<int, int>& cellsCompletedInRoom,
-						   int verbosity) {
+						   int verbosity, CellList* filledCells,
+						   FillScratch* scratch) {
+	// Nothing to print, so a kernel built for the board's size can do it.
+	if (verbosity == 0 &&
+		fillKnownCellsFixedSize(cellValues, roomMap, cellsCompletedInRoom,
+								filledCells)) {
+		return;
+	}
 	bool modifiedBoard;
 	do {
 		modifiedBoard = false;
@@ -348,9 +1882,9 @@ void fillKnownCellsInBoard(Board& cellValues, const Board& roomIds,
 				// This room is already complete, don't waste time here.
 				continue;
 			}
-			int cellsFilled =
-				fillKnownCellsInRoom(cellValues, roomIds, roomAndCells.first,
-									 roomAndCells.second, verbosity);
+			int cellsFilled = fillKnownCellsInRoom(
+				cellValues, roomIds, roomAndCells.first, roomAndCells.second,
+				verbosity, filledCells, scratch);
 			cellsCompletedInRoom[roomAndCells.first] += cellsFilled;
 			if (cellsFilled > 0) {
 				modifiedBoard = true;
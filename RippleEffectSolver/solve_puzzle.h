@@ -9,48 +9,127 @@
 #ifndef solve_puzzle_h
 #define solve_puzzle_h
 
+#include <functional>
 #include <map>
+#include <memory>
 #include <set>
 #include <utility>
 #include <vector>
 
+#include "solver_options.h"
 #include "typedefs.h"
 
 // Attempts to fill in known cells first, branching only if necessary. Returns
 // true the first instant that a valid board is found. Returns false if no
-// solution exists. To find multiple solutions, see findAllSolutions.
+// solution exists. To find multiple solutions, see findAllSolutions. Every
+// search routine below also takes optional SolverOptions; see solver_options.h.
 std::pair<bool, Board> findSingleSolution(
-	Board /* intentional copy */ cellValues, const Board& roomIds,
-	const RoomMap& roomMap,
-	std::map<int, int> /* intentional copy */ cellsCompletedInRoom,
-	int verbosity);
+	const Board& cellValues, const Board& roomIds, const RoomMap& roomMap,
+	const std::map<int, int>& cellsCompletedInRoom, int verbosity,
+	const SolverOptions& options = SolverOptions());
+
+// Uses the same logic as above, but visits every valid solution to the supplied
+// board, handing each one to `onSolution` as soon as it is found rather than
+// collecting them. Returning false from `onSolution` stops the search early.
+// Returns the number of solutions visited. Memory use depends only on the board
+// size, so this is the way to go when there are too many solutions to keep.
+// The search keeps its own stack rather than recursing, so it can save its
+// progress to a checkpoint file and resume from it (see SolverOptions).
+long long enumerateSolutions(
+	const Board& cellValues, const Board& roomIds, const RoomMap& roomMap,
+	const std::map<int, int>& cellsCompletedInRoom, int verbosity,
+	const std::function<bool(const Board&)>& onSolution,
+	const SolverOptions& options = SolverOptions());
 
 // Uses the same logic as above, but returns only once all valid solutions to
 // the supplied board are found. If `solutionCount` is not null, a message will
 // print with the current total number of solutions found every time a new
 // valid configuration is found.
 std::pair<bool, std::set<Board>> findAllSolutions(
-	Board /* intentional copy */ cellValues, const Board& roomIds,
-	const RoomMap& roomMap,
-	std::map<int, int> /* intentional copy */ cellsCompletedInRoom,
-	int verbosity, int* solutionCount = nullptr);
+	const Board& cellValues, const Board& roomIds, const RoomMap& roomMap,
+	const std::map<int, int>& cellsCompletedInRoom, int verbosity,
+	int* solutionCount = nullptr,
+	const SolverOptions& options = SolverOptions());
+
+// Uses the same search as findAllSolutions, but only counts solutions rather
+// than keeping them around. Stops as soon as `limit` solutions have been seen if
+// `limit` is positive, so a limit of 2 makes for a cheap uniqueness check.
+long long countSolutions(
+	const Board& cellValues, const Board& roomIds, const RoomMap& roomMap,
+	const std::map<int, int>& cellsCompletedInRoom, int verbosity,
+	long long limit = 0,
+	const SolverOptions& options = SolverOptions());
+
+struct SearchWorkspace;
+
+// Runs the searches above on boards with a fixed room layout, keeping the room
+// map and all the memory a search works in from one call to the next. Only
+// worth it when searching many boards with the same rooms, as augmenting a
+// puzzle does, but then nothing needs allocating after the first search. Each
+// Solver may only run one search at a time; use one per thread.
+class Solver {
+   public:
+	explicit Solver(const Board& roomIds);
+	~Solver();
+
+	const RoomMap& roomMap() const { return rooms; }
+
+	std::pair<bool, Board> findSingleSolution(
+		const Board& cellValues, int verbosity,
+		const SolverOptions& options = SolverOptions());
+	long long enumerateSolutions(
+		const Board& cellValues, int verbosity,
+		const std::function<bool(const Board&)>& onSolution,
+		const SolverOptions& options = SolverOptions());
+	std::pair<bool, std::set<Board>> findAllSolutions(
+		const Board& cellValues, int verbosity, int* solutionCount = nullptr,
+		const SolverOptions& options = SolverOptions());
+	long long countSolutions(const Board& cellValues, int verbosity,
+							 long long limit = 0,
+							 const SolverOptions& options = SolverOptions());
+
+   private:
+	// Recounts `completed` for `cellValues`.
+	void countCompleted(const Board& cellValues);
+
+	Board roomIds;
+	RoomMap rooms;
+	bool roomsValid;
+	std::map<int, int> completed;
+	std::unique_ptr<SearchWorkspace> workspace;
+};
 
 // Scans all supplied boards, returning an aggregate board containing only
 // values that appear the same in every single one. Assumes that at least one
 // board is supplied.
 Board aggregateBoards(const std::set<Board>& boards);
 
+// Scratch space for the two functions below, so that calling them over and
+// over doesn't allocate each time.
+struct FillScratch {
+	std::vector<char> usedNumber;
+	CellList emptyCells;
+	std::vector<int> possibleValues;
+};
+
 // Loops over a particular room until no cells can be filled in with 100%
-// certainty. Returns the number of cells filled in.
+// certainty. Returns the number of cells filled in. If `filledCells` is not
+// null, every cell filled in is appended to it. If `scratch` is not null, it's
+// worked in rather than fresh memory.
 int fillKnownCellsInRoom(Board& cellValues, const Board& roomIds, int room,
-						 const CellList& cellsInRoom, int verbosity);
+						 const CellList& cellsInRoom, int verbosity,
+						 CellList* filledCells = nullptr,
+						 FillScratch* scratch = nullptr);
 
 // Loops over the entire board until no cells can be filled in with 100%
-// certainty. Updates cellsCompletedInRoom as appropriate.
+// certainty. Updates cellsCompletedInRoom as appropriate. If `filledCells` is
+// not null, every cell filled in is appended to it. Takes `scratch` like
+// fillKnownCellsInRoom.
 void fillKnownCellsInBoard(Board& cellValues, const Board& roomIds,
 						   const RoomMap& roomMap,
 						   std::map<int, int>& cellsCompletedInRoom,
-						   int verbosity);
+						   int verbosity, CellList* filledCells = nullptr,
+						   FillScratch* scratch = nullptr);
 
 // Generates two maps, one mapping room ID to a list of cells in the room, and
 // the other mapping room ID to the count of completed cells in the room so far.
@@ -6,12 +6,26 @@
 //  Copyright © 2017 Hunter Knepshield. All rights reserved.
 //
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
 
+#include "board_writer.h"
+#include "portfolio.h"
 #include "print_board.h"
 #include "read_input.h"
+#include "room_tables.h"
+#include "search_trace.h"
+#include "solution_cache.h"
+#include "solution_store.h"
 #include "solve_puzzle.h"
+#include "solver_options.h"
+#include "transposition_table.h"
 #include "typedefs.h"
 #include "validity_checks.h"
 
@@ -26,6 +40,109 @@ int verbosity = 0;
 // all solutions (or none).
 bool generateAllSolutions = false;
 
+// Search engine settings. false = fill in known cells and backtrack, true =
+// learn a nogood from every dead end and backjump past irrelevant choices. The
+// learning engine ignores the propagation, table and probing settings below.
+bool useLearningEngine = false;
+
+// Solution storage settings, only used when generating all solutions. 0 = keep
+// every solution in memory, n > 0 = pack solutions into at most n megabytes of
+// memory, spilling sorted runs to temporary files beyond that.
+int solutionMemoryLimitMB = 0;
+
+// Transposition table settings. 0 = no table, n > 0 = remember up to n partial
+// boards that have already been fully explored, so that reaching one again via
+// a different order of branches doesn't explore it twice.
+int transpositionTableEntries = 0;
+
+// Line rule settings. false = only rule out values that clash with filled in
+// cells, true = also rule out values within ripple range of everywhere another
+// room could put the same value.
+bool useLineRules = false;
+
+// Room matching settings. false = only fill in cells with a single possible
+// value or values with a single possible cell, true = also rule out any value
+// that would leave the rest of its room impossible to fill in.
+bool useRoomMatching = false;
+
+// Room table settings. 0 = no tables, n > 0 = list every way of filling in each
+// room of up to n cells up front, and keep track of which still fit the board.
+// Each table has n! entries, so n should stay small (5 or 6 is plenty).
+int roomTableMaxCells = 0;
+
+// Room branching settings, only used with room tables. false = branch on one
+// cell at a time, true = branch on every remaining filling of the most
+// constrained room.
+bool branchOnRooms = false;
+
+// Probing settings. 0 = branch as soon as filling in known cells gets stuck,
+// n > 0 = first try up to n candidate values per search node, ruling out any
+// that lead straight to a contradiction.
+long long probeBudget = 0;
+
+// Value ordering settings. 0 = ascending, 1 = least constraining value first,
+// 2 = value whose ripple covers the fewest empty cells first, 3 = random.
+int valueOrder = 0;
+
+// Restart settings, only used when finding a single solution. 0 = never
+// restart, 1 = restart after restartNodes times the Luby sequence (1, 1, 2, 1,
+// 1, 2, 4, ...) search nodes, 2 = restart after restartNodes search nodes,
+// growing by half each time. Attempts after the first break ties in the value
+// order at random, seeded by randomSeed.
+int restartSchedule = 0;
+int restartNodes = 100;
+unsigned randomSeed = 0;
+
+// Portfolio settings, only used when finding a single solution. 0 = run the
+// search configured above, n > 0 = instead race n differently configured
+// searches on n threads and take whichever answers first.
+int portfolioThreads = 0;
+
+// Budget settings. Each is 0 for no limit. Past nodeBudget search nodes or
+// timeLimitSeconds seconds, the search gives up and reports what it found so
+// far. When generating all solutions without solutionMemoryLimitMB, the search
+// also gives up once the solutions it holds take about solutionSetLimitMB
+// megabytes.
+long long nodeBudget = 0;
+double timeLimitSeconds = 0;
+int solutionSetLimitMB = 0;
+
+// Checkpoint settings, only used when generating all solutions. Empty = start
+// from scratch every time, a file name = save how far the search has got to
+// that file every checkpointSeconds seconds and when any budget runs out, and
+// carry on from it if it exists, so that a long run can be stopped and resumed.
+std::string checkpointPath = "";
+double checkpointSeconds = 60;
+
+// Trace settings. Empty = don't trace, a file name = record every branch,
+// batch of filling in known cells and backtrack the search makes, with
+// timestamps, and write them to that file once it's done: traceJsonPath as
+// Chrome trace events (for chrome://tracing or Perfetto), traceFoldedPath as
+// folded stacks (for flamegraph.pl or speedscope). The learning engine isn't
+// traced.
+std::string traceJsonPath = "";
+std::string traceFoldedPath = "";
+
+// Output format settings. 0 = draw each solution as a board, 1 = print each
+// solution on one line as every cell's value, row by row, 2 = print each
+// solution as one line of JSON. With 1 or 2, only solutions go to stdout; the
+// initial board isn't printed and every other message goes to stderr.
+int outputFormat = 0;
+
+// Solution cache settings. Empty = always search, a file name = keep what
+// finished searches found in that file, created with room for
+// solutionCacheSlots puzzles if it doesn't exist, and answer the same puzzle
+// from it next time without searching. Rooms may be numbered differently. Only
+// used when finding a single solution or all solutions without
+// solutionMemoryLimitMB. The file can be shared with other solvers and servers
+// running at the same time.
+std::string solutionCachePath = "";
+int solutionCacheSlots = 1 << 16;
+
+// Statistics settings. false = print only the result, true = also print
+// counters describing the work the search did.
+bool printStats = false;
+
 int main(void) {
 	size_t boardWidth = 0;
 	Board cellValues, roomIds;
@@ -33,8 +150,15 @@ int main(void) {
 		!readRooms(boardWidth, cellValues.size(), &roomIds)) {
 		return 1;
 	}
-	std::cout << "Initial board state:" << std::endl;
-	printBoard(cellValues, roomIds);
+	OutputFormat format = outputFormat == 1   ? OutputFormat::kCompact
+						  : outputFormat == 2 ? OutputFormat::kJsonLines
+											  : OutputFormat::kPretty;
+	std::ostream& messages =
+		format == OutputFormat::kPretty ? std::cout : std::cerr;
+	if (format == OutputFormat::kPretty) {
+		std::cout << "Initial board state:" << std::endl;
+		printBoard(cellValues, roomIds);
+	}
 
 	// Now some initial setup...
 	// Maps room ID to a list of pairs of cell coordinates in the room.
@@ -53,32 +177,196 @@ int main(void) {
 	// To get the value of cell (r, c), use cellValues[r][c].
 	// To get the room ID of cell (r, c), use roomIds[r][c].
 
-	if (generateAllSolutions) {
-		const auto& solvedWithBoards = findAllSolutions(
-			cellValues, roomIds, roomMap, cellsCompletedInRoom, verbosity);
+	SolverStats stats;
+	SolverOptions options;
+	options.stats = &stats;
+	if (useLearningEngine) {
+		options.engine = SearchEngine::kLearning;
+	}
+	options.lineRules = useLineRules;
+	options.roomMatching = useRoomMatching;
+	options.roomBranching = branchOnRooms;
+	std::unique_ptr<RoomTables> roomTables;
+	if (roomTableMaxCells > 0) {
+		roomTables.reset(new RoomTables(roomMap, roomTableMaxCells));
+		options.roomTables = roomTables.get();
+	}
+	options.probeBudget = probeBudget;
+	options.valueOrder = static_cast<ValueOrder>(valueOrder);
+	options.restartSchedule = static_cast<RestartSchedule>(restartSchedule);
+	options.restartBase = restartNodes;
+	options.seed = randomSeed;
+	SolveStatus status = SolveStatus::kFinished;
+	options.status = &status;
+	options.nodeBudget = nodeBudget;
+	if (timeLimitSeconds > 0) {
+		options.deadline =
+			std::chrono::steady_clock::now() +
+			std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+				std::chrono::duration<double>(timeLimitSeconds));
+	}
+	options.memoryBudget = (size_t)solutionSetLimitMB << 20;
+	options.checkpointPath = checkpointPath;
+	options.checkpointSeconds = checkpointSeconds;
+	std::unique_ptr<TranspositionTable> transpositionTable;
+	if (transpositionTableEntries > 0) {
+		size_t largestRoom = 0;
+		for (const auto& roomAndCells : roomMap) {
+			largestRoom = std::max(largestRoom, roomAndCells.second.size());
+		}
+		transpositionTable.reset(new TranspositionTable(
+			(int)cellValues.size(), (int)boardWidth, (int)largestRoom,
+			transpositionTableEntries));
+		options.transpositionTable = transpositionTable.get();
+	}
+	std::unique_ptr<SearchTracer> tracer;
+	if (!traceJsonPath.empty() || !traceFoldedPath.empty()) {
+		tracer.reset(new SearchTracer());
+		options.tracer = tracer.get();
+	}
+
+	std::unique_ptr<SolutionCache> solutionCache;
+	CachedResult cached;
+	if (!solutionCachePath.empty()) {
+		solutionCache.reset(
+			new SolutionCache(solutionCachePath, solutionCacheSlots));
+		if (!solutionCache->isOpen()) {
+			std::cerr << "Failed to open the solution cache." << std::endl;
+			return 1;
+		}
+		solutionCache->lookup(cellValues, roomIds, &cached);
+	}
+
+	if (generateAllSolutions && solutionMemoryLimitMB > 0) {
+		SolutionStore store((int)boardWidth, (int)cellValues.size(),
+							(size_t)solutionMemoryLimitMB << 20);
+		bool stored = true;
+		enumerateSolutions(
+			cellValues, roomIds, roomMap, cellsCompletedInRoom, verbosity,
+			[&store, &stored](const Board& board) {
+				return stored = store.insert(board);
+			},
+			options);
+		if (!stored || !store.finish()) {
+			std::cerr << "Failed to store solutions." << std::endl;
+			return 1;
+		}
+		if (store.size()) {
+			messages << "The puzzle has " << store.size() << " solution"
+					 << (store.size() > 1 ? "s" : "") << "." << std::endl;
+			BoardWriter writer(std::cout, format, roomIds);
+			store.forEach([&writer](const Board& board) {
+				writer.write(board);
+				return true;
+			});
+		} else {
+			messages << "No solutions." << std::endl;
+		}
+	} else if (generateAllSolutions) {
+		std::pair<bool, std::set<Board>> solvedWithBoards;
+		if (cached.answersAll()) {
+			solvedWithBoards.first = cached.solutionCount > 0;
+			if (solvedWithBoards.first) {
+				solvedWithBoards.second.insert(cached.solution);
+			}
+		} else {
+			solvedWithBoards =
+				findAllSolutions(cellValues, roomIds, roomMap,
+								 cellsCompletedInRoom, verbosity, nullptr,
+								 options);
+			if (solutionCache && status == SolveStatus::kFinished) {
+				CachedResult found;
+				found.solutionCount = solvedWithBoards.second.size();
+				if (solvedWithBoards.first) {
+					found.solution = *solvedWithBoards.second.begin();
+				}
+				solutionCache->store(cellValues, roomIds, found);
+			}
+		}
 		if (solvedWithBoards.first) {
-			std::cout << "The puzzle has " << solvedWithBoards.second.size()
-					  << " solution"
-					  << (solvedWithBoards.second.size() > 1 ? "s" : "") << "."
-					  << std::endl;
-			int solution = 0;
+			messages << "The puzzle has " << solvedWithBoards.second.size()
+					 << " solution"
+					 << (solvedWithBoards.second.size() > 1 ? "s" : "") << "."
+					 << std::endl;
+			BoardWriter writer(std::cout, format, roomIds);
 			for (const auto& board : solvedWithBoards.second) {
-				std::cout << "Solution " << ++solution << ":" << std::endl;
-				printBoard(board, roomIds);
+				writer.write(board);
 			}
 		} else {
-			std::cout << "No solutions." << std::endl;
+			messages << "No solutions." << std::endl;
 		}
 	} else {
-		const auto& solvedWithBoard = findSingleSolution(
-			cellValues, roomIds, roomMap, cellsCompletedInRoom, verbosity);
-		if (solvedWithBoard.first) {
+		std::pair<bool, Board> solvedWithBoard;
+		if (cached.answersSingle()) {
+			solvedWithBoard = {cached.solutionCount != 0, cached.solution};
+		} else if (portfolioThreads > 0) {
+			auto configurations = defaultPortfolio(
+				portfolioThreads, randomSeed, roomTables.get());
+			for (auto& configuration : configurations) {
+				configuration.stats = &stats;
+				configuration.status = &status;
+				configuration.nodeBudget = nodeBudget;
+				configuration.deadline = options.deadline;
+				configuration.tracer = options.tracer;
+			}
+			int winner;
+			solvedWithBoard = findSingleSolutionPortfolio(
+				cellValues, roomIds, roomMap, cellsCompletedInRoom, verbosity,
+				configurations, &winner);
+			// Every loser was cancelled, so only the winner's status counts.
+			if (winner != -1) status = SolveStatus::kFinished;
+		} else {
+			solvedWithBoard =
+				findSingleSolution(cellValues, roomIds, roomMap,
+								   cellsCompletedInRoom, verbosity, options);
+		}
+		if (solutionCache && !cached.answersSingle() &&
+			status == SolveStatus::kFinished) {
+			CachedResult found;
+			if (solvedWithBoard.first) {
+				found.solution = solvedWithBoard.second;
+			} else {
+				found.solutionCount = 0;
+			}
+			solutionCache->store(cellValues, roomIds, found);
+		}
+		if (solvedWithBoard.first && format == OutputFormat::kPretty) {
 			std::cout << "Solved the puzzle. Final state:" << std::endl;
 			printBoard(solvedWithBoard.second, roomIds);
+		} else if (solvedWithBoard.first) {
+			BoardWriter(std::cout, format, roomIds)
+				.write(solvedWithBoard.second);
+		} else if (status == SolveStatus::kFinished) {
+			messages << "No solution." << std::endl;
 		} else {
-			std::cout << "No solution." << std::endl;
+			messages << "No solution found." << std::endl;
+		}
+	}
+
+	if (tracer) {
+		if (tracer->dropped()) {
+			std::cerr << "The trace is missing " << tracer->dropped()
+					  << " events that didn't fit." << std::endl;
+		}
+		if ((!traceJsonPath.empty() &&
+			 !tracer->writeChromeTrace(traceJsonPath)) ||
+			(!traceFoldedPath.empty() &&
+			 !tracer->writeFoldedStacks(traceFoldedPath))) {
+			std::cerr << "Failed to write the trace." << std::endl;
 		}
 	}
 
+	if (status != SolveStatus::kFinished) {
+		messages << "The search " << describeStatus(status)
+				 << " before finishing, so "
+				 << (generateAllSolutions ? "there may be more solutions."
+										  : "a solution may still exist.")
+				 << std::endl;
+	}
+
+	if (printStats) {
+		printSolverStats(stats, messages);
+	}
+
 	return 0;
 }
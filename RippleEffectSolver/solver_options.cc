@@ -0,0 +1,168 @@
+//
+//  solver_options.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "solver_options.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+void addSolverStats(const SolverStats& from, SolverStats* to) {
+	to->nodes += from.nodes;
+	to->branches += from.branches;
+	to->deadEnds += from.deadEnds;
+	to->transpositionHits += from.transpositionHits;
+	to->transpositionMisses += from.transpositionMisses;
+	to->transpositionStores += from.transpositionStores;
+	to->transpositionEvictions += from.transpositionEvictions;
+	to->lineEliminations += from.lineEliminations;
+	to->lineFills += from.lineFills;
+	to->matchingEliminations += from.matchingEliminations;
+	to->matchingFills += from.matchingFills;
+	to->roomFillingsRejected += from.roomFillingsRejected;
+	to->roomTableEliminations += from.roomTableEliminations;
+	to->roomTableFills += from.roomTableFills;
+	to->conflicts += from.conflicts;
+	to->learnedNogoods += from.learnedNogoods;
+	to->restarts += from.restarts;
+	to->probes += from.probes;
+	to->probeEliminations += from.probeEliminations;
+	to->probeFills += from.probeFills;
+#ifdef PERF_COUNTERS
+	for (int phase = 0; phase < kPerfPhases; phase++) {
+		to->perf[phase].calls += from.perf[phase].calls;
+		for (int i = 0; i < kPerfCounters; i++) {
+			to->perf[phase].values[i] += from.perf[phase].values[i];
+		}
+	}
+#endif /* PERF_COUNTERS */
+}
+
+void printSolverStats(const SolverStats& stats, std::ostream& out) {
+	out << "Search nodes: " << stats.nodes << std::endl;
+	out << "Branches: " << stats.branches << std::endl;
+	out << "Dead ends: " << stats.deadEnds << std::endl;
+	long long lookups = stats.transpositionHits + stats.transpositionMisses;
+	if (lookups) {
+		out << "Transposition table hits: " << stats.transpositionHits << " of "
+			<< lookups << " lookups ("
+			<< stats.transpositionHits * 100 / lookups << "%)" << std::endl;
+		out << "Transposition table stores: " << stats.transpositionStores
+			<< " (" << stats.transpositionEvictions << " evictions)"
+			<< std::endl;
+	}
+	if (stats.roomFillingsRejected) {
+		out << "Room tables: " << stats.roomFillingsRejected
+			<< " fillings rejected, " << stats.roomTableEliminations
+			<< " values ruled out, " << stats.roomTableFills
+			<< " cells filled in" << std::endl;
+	}
+	if (stats.lineEliminations) {
+		out << "Line rules: " << stats.lineEliminations << " values ruled out, "
+			<< stats.lineFills << " cells filled in" << std::endl;
+	}
+	if (stats.matchingEliminations || stats.matchingFills) {
+		out << "Room matching: " << stats.matchingEliminations
+			<< " values ruled out, " << stats.matchingFills
+			<< " cells filled in" << std::endl;
+	}
+	if (stats.conflicts) {
+		out << "Conflicts: " << stats.conflicts << " ("
+			<< stats.learnedNogoods << " nogoods learned, " << stats.restarts
+			<< " restarts)" << std::endl;
+	}
+	if (stats.probes) {
+		out << "Probes: " << stats.probes << " (" << stats.probeEliminations
+			<< " values ruled out, " << stats.probeFills
+			<< " cells filled in)" << std::endl;
+	}
+#ifdef PERF_COUNTERS
+	static const char* const kPhaseNames[kPerfPhases] = {
+		"Propagation", "Branching", "Validation", "Aggregation"};
+	for (int phase = 0; phase < kPerfPhases; phase++) {
+		const PerfCounts& counts = stats.perf[phase];
+		if (!counts.calls) continue;
+		out << kPhaseNames[phase] << ": " << counts.calls << " calls";
+		for (int i = 0; i < kPerfCounters; i++) {
+			out << ", ";
+			if (perfCounterAvailable(i)) {
+				out << counts.values[i];
+			} else {
+				out << "n/a";
+			}
+			out << " " << describePerfCounter(i);
+		}
+		if (counts.values[kCycles]) {
+			out << " (" << (double)counts.values[kInstructions] /
+							   counts.values[kCycles]
+				<< " instructions per cycle)";
+		}
+		out << std::endl;
+	}
+#endif /* PERF_COUNTERS */
+}
+
+SolveStatus checkBudgets(const SolverOptions& options, long long nodes) {
+	if ((options.cancelled &&
+		 options.cancelled->load(std::memory_order_relaxed)) ||
+		(options.alsoCancelled &&
+		 options.alsoCancelled->load(std::memory_order_relaxed))) {
+		return SolveStatus::kCancelled;
+	}
+	if (options.nodeBudget > 0 && nodes >= options.nodeBudget) {
+		return SolveStatus::kOutOfNodes;
+	}
+	if (options.deadline != std::chrono::steady_clock::time_point::max() &&
+		std::chrono::steady_clock::now() >= options.deadline) {
+		return SolveStatus::kOutOfTime;
+	}
+	return SolveStatus::kFinished;
+}
+
+const char* describeStatus(SolveStatus status) {
+	switch (status) {
+		case SolveStatus::kFinished:
+			return "finished";
+		case SolveStatus::kOutOfNodes:
+			return "ran out of search nodes";
+		case SolveStatus::kOutOfTime:
+			return "ran out of time";
+		case SolveStatus::kOutOfMemory:
+			return "ran out of memory";
+		case SolveStatus::kCancelled:
+			return "was cancelled";
+	}
+	return "";
+}
+
+long long lubyTerm(int i) {
+	int size = 1, exponent = 0;
+	while (size < i + 1) {
+		exponent++;
+		size = 2 * size + 1;
+	}
+	while (size - 1 != i) {
+		size = (size - 1) >> 1;
+		exponent--;
+		i = i % size;
+	}
+	return 1LL << exponent;
+}
+
+long long restartNodeBudget(const SolverOptions& options, int restart) {
+	switch (options.restartSchedule) {
+		case RestartSchedule::kLuby:
+			return options.restartBase * lubyTerm(restart);
+		case RestartSchedule::kGeometric:
+			return (long long)(options.restartBase *
+							   std::pow(options.restartGrowth, restart));
+		default:
+			return 0;
+	}
+}
@@ -0,0 +1,212 @@
+//
+//  solver_options.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef solver_options_h
+#define solver_options_h
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "perf_counters.h"
+
+class RoomTables;
+class SearchTracer;
+class TranspositionTable;
+
+// Counters describing the work a search did. Every counter only ever goes up,
+// so the same struct can be passed to several searches to get totals.
+struct SolverStats {
+	// Partial boards visited by the search.
+	long long nodes = 0;
+	// Values tried while branching.
+	long long branches = 0;
+	// Partial boards that turned out to have no solutions.
+	long long deadEnds = 0;
+	// Transposition table lookups that found the board, and that didn't.
+	long long transpositionHits = 0;
+	long long transpositionMisses = 0;
+	// Results written to the transposition table, and how many of those
+	// pushed out an entry for a different board.
+	long long transpositionStores = 0;
+	long long transpositionEvictions = 0;
+	// Values ruled out of cells by line rules, and cells filled in because line
+	// rules left them only one value.
+	long long lineEliminations = 0;
+	long long lineFills = 0;
+	// Values ruled out of cells by room matching, and cells filled in because
+	// matching left them only one value. These include work done on probing's
+	// scratch boards.
+	long long matchingEliminations = 0;
+	long long matchingFills = 0;
+	// Room fillings from room tables found to disagree with the board, values
+	// ruled out of cells because no remaining filling uses them, and cells
+	// filled in because every remaining filling agrees on them.
+	long long roomFillingsRejected = 0;
+	long long roomTableEliminations = 0;
+	long long roomTableFills = 0;
+	// Constraints the learning engine found broken, and nogoods it learned
+	// from them.
+	long long conflicts = 0;
+	long long learnedNogoods = 0;
+	// Times a search abandoned its choices and started over.
+	long long restarts = 0;
+	// Values tentatively placed by probing, how many of those led to a
+	// contradiction and so were ruled out, and how many cells were filled in
+	// because every other value for them was ruled out.
+	long long probes = 0;
+	long long probeEliminations = 0;
+	long long probeFills = 0;
+#ifdef PERF_COUNTERS
+	// Hardware counts for each phase of the search, indexed by PerfPhase.
+	PerfCounts perf[kPerfPhases];
+#endif /* PERF_COUNTERS */
+};
+
+// Which search does the work.
+enum class SearchEngine {
+	// Fill in known cells, then branch on a cell (or room) and backtrack.
+	kBacktracking,
+	// Conflict-driven nogood learning with backjumping and restarts; see
+	// learning_solver.h. Ignores every other option except `stats`,
+	// `cancelled` and `alsoCancelled`.
+	kLearning,
+};
+
+// The order the backtracking search tries values in when it branches.
+enum class ValueOrder {
+	kAscending,
+	// Values that take the fewest remaining options away from other empty
+	// cells in range of their ripple or in the same room come first.
+	kLeastConstraining,
+	// Values whose ripple covers the fewest empty cells come first. Cheaper to
+	// work out than kLeastConstraining, but cruder.
+	kSmallestFootprint,
+	kRandom,
+};
+
+// How many search nodes findSingleSolution allows each attempt before
+// starting over, if at all.
+enum class RestartSchedule {
+	kNone,
+	// `restartBase` times the Luby sequence: 1, 1, 2, 1, 1, 2, 4, 1, ...
+	kLuby,
+	// `restartBase`, then `restartGrowth` times as many each time after.
+	kGeometric,
+};
+
+// How a search ended. Anything but kFinished means it stopped early, and what
+// it returned is partial: no solution, the solutions found so far, or a lower
+// bound on the count, as the case may be.
+enum class SolveStatus {
+	kFinished,
+	kOutOfNodes,
+	kOutOfTime,
+	kOutOfMemory,
+	kCancelled,
+};
+
+// Optional extras for the search routines in solve_puzzle.h. The defaults
+// reproduce the plain search.
+struct SolverOptions {
+	SearchEngine engine = SearchEngine::kBacktracking;
+	// If not null, the search adds what it did to these counters.
+	SolverStats* stats = nullptr;
+	// If not null, the search stops as soon as it notices this has become
+	// true, from this thread or any other, and returns what it has so far.
+	const std::atomic<bool>* cancelled = nullptr;
+	// The same as `cancelled`, for when something besides the caller may
+	// cancel the search too, such as a portfolio once another search wins.
+	const std::atomic<bool>* alsoCancelled = nullptr;
+	// If not null, set to how the search ended.
+	SolveStatus* status = nullptr;
+	// Budgets, past which the search stops and returns what it has so far. If
+	// positive, the most search nodes (across every restart) to visit.
+	long long nodeBudget = 0;
+	// The time by which to give up, if any.
+	std::chrono::steady_clock::time_point deadline =
+		std::chrono::steady_clock::time_point::max();
+	// If positive, roughly the most bytes findAllSolutions may spend holding
+	// on to solutions. The other searches use memory that depends only on the
+	// board size.
+	size_t memoryBudget = 0;
+	// If not null, the search skips partial boards already known to be dead
+	// ends, and counting skips boards whose solutions were already counted.
+	// Must be sized for the board being solved.
+	TranspositionTable* transpositionTable = nullptr;
+	// If true, filling in known cells also rules out any value for an empty
+	// cell that is within ripple range of every cell where some other room
+	// could put that value.
+	bool lineRules = false;
+	// If true, filling in known cells also rules out any value for an empty
+	// cell that would leave the rest of its room impossible to fill in, which
+	// finds hidden pairs, triples and so on rather than just single values.
+	bool roomMatching = false;
+	// If not null, filling in known cells also keeps track of which of each
+	// small room's fillings still agree with the board, and fills in or rules
+	// out values accordingly. Must be built for the board being solved.
+	const RoomTables* roomTables = nullptr;
+	// If true (and there are room tables), the search branches by filling in
+	// the room with the fewest remaining fillings all at once, rather than one
+	// cell at a time.
+	bool roomBranching = false;
+	// If positive, once filling in known cells gets stuck, each search node
+	// tries placing up to this many candidate values one at a time, filling in
+	// known cells after each, and rules out any that lead to a contradiction.
+	// Probing stops early once a full pass over the board rules nothing out.
+	long long probeBudget = 0;
+	ValueOrder valueOrder = ValueOrder::kAscending;
+	// Only used by findSingleSolution. Every attempt after the first breaks
+	// ties in the value order at random (and every value ties when ascending),
+	// so that each attempt explores differently. A transposition table carries
+	// the dead ends found by one attempt over to the next.
+	RestartSchedule restartSchedule = RestartSchedule::kNone;
+	long long restartBase = 100;
+	double restartGrowth = 1.5;
+	// Seeds everything random, so that runs are reproducible.
+	uint64_t seed = 0;
+	// If not empty, enumerateSolutions (and so findAllSolutions) saves how far
+	// it has got to this file every `checkpointSeconds` seconds and whenever
+	// it stops early, be it on a budget or because its callback asked it to
+	// (as findAllSolutions does past `memoryBudget`), and picks up from the
+	// file rather than starting over if it already exists. The file is
+	// removed once the search finishes. Resuming needs the same board and
+	// options, and solutions visited after the last save are visited again.
+	// Ignored by the learning engine.
+	std::string checkpointPath;
+	double checkpointSeconds = 60;
+	// If not null, the backtracking engine records its branches, batches of
+	// filling in known cells and backtracks here (see search_trace.h).
+	SearchTracer* tracer = nullptr;
+};
+
+// Whether a search that has visited `nodes` search nodes may carry on under the
+// options' budgets and cancellation flag. Returns kFinished if so, or else the
+// reason it has to stop.
+SolveStatus checkBudgets(const SolverOptions& options, long long nodes);
+
+// A short description of how a search ended, such as "ran out of time".
+const char* describeStatus(SolveStatus status);
+
+// The `i`th term (counting from 0) of the Luby sequence.
+long long lubyTerm(int i);
+
+// The node budget for attempt number `restart` (counting from 0) under the
+// options' restart schedule, or 0 for no limit.
+long long restartNodeBudget(const SolverOptions& options, int restart);
+
+// Adds every counter in `from` to `to`.
+void addSolverStats(const SolverStats& from, SolverStats* to);
+
+// Prints every counter in `stats` to `out`, one per line.
+void printSolverStats(const SolverStats& stats, std::ostream& out = std::cout);
+
+#endif /* solver_options_h */
@@ -0,0 +1,92 @@
+//
+//  transposition_table.cc
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#include "transposition_table.h"
+
+#include <random>
+#include <vector>
+
+#include "solver_options.h"
+#include "typedefs.h"
+
+TranspositionTable::TranspositionTable(int height, int width, int maxValue,
+									   size_t capacity)
+	: height(height), width(width), maxValue(maxValue) {
+	// A fixed seed keeps hashes (and so collisions, however unlikely) the same
+	// from run to run.
+	std::mt19937_64 rng(0x5EED);
+	keys.resize((size_t)height * width * (maxValue + 1));
+	for (auto& key : keys) {
+		key = rng();
+	}
+	size_t buckets = 1;
+	while (buckets * 4 <= capacity) {
+		buckets *= 2;
+	}
+	entries.resize(buckets * 2);
+	bucketMask = buckets - 1;
+	clear();
+}
+
+uint64_t TranspositionTable::hashBoard(const Board& cellValues) const {
+	uint64_t hash = 0;
+	for (int r = 0; r < cellValues.size(); r++) {
+		for (int c = 0; c < cellValues[r].size(); c++) {
+			if (cellValues[r][c]) {
+				hash ^= cellKey(r, c, cellValues[r][c]);
+			}
+		}
+	}
+	return hash;
+}
+
+bool TranspositionTable::probe(uint64_t hash, long long* solutions,
+							   SolverStats* stats) const {
+	const Entry* bucket = &entries[(hash & bucketMask) * 2];
+	for (int i = 0; i < 2; i++) {
+		if (bucket[i].used && bucket[i].hash == hash) {
+			*solutions = bucket[i].solutions;
+			if (stats) stats->transpositionHits++;
+			return true;
+		}
+	}
+	if (stats) stats->transpositionMisses++;
+	return false;
+}
+
+void TranspositionTable::store(uint64_t hash, long long solutions,
+							   long long nodes, SolverStats* stats) {
+	Entry* bucket = &entries[(hash & bucketMask) * 2];
+	Entry entry = {hash, solutions, nodes, true};
+	if (stats) stats->transpositionStores++;
+	// Refresh the entry in place if this board is already here.
+	for (int i = 0; i < 2; i++) {
+		if (bucket[i].used && bucket[i].hash == hash) {
+			bucket[i] = entry;
+			return;
+		}
+	}
+	if (!bucket[0].used || nodes >= bucket[0].nodes) {
+		// The expensive entry gets demoted to the always-replace slot rather
+		// than thrown away outright.
+		if (bucket[0].used) {
+			if (bucket[1].used && stats) stats->transpositionEvictions++;
+			bucket[1] = bucket[0];
+		}
+		bucket[0] = entry;
+	} else {
+		if (bucket[1].used && stats) stats->transpositionEvictions++;
+		bucket[1] = entry;
+	}
+}
+
+void TranspositionTable::clear() {
+	for (auto& entry : entries) {
+		entry.used = false;
+	}
+}
@@ -0,0 +1,82 @@
+//
+//  transposition_table.h
+//  RippleEffectSolver
+//
+//  Created by Hunter Knepshield on 10/19/26.
+//  Copyright © 2026 Hunter Knepshield. All rights reserved.
+//
+
+#ifndef transposition_table_h
+#define transposition_table_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "typedefs.h"
+
+struct SolverStats;
+
+// A fixed-size cache of partial boards the search has already fully explored,
+// so that reaching the same board again through a different sequence of
+// branches doesn't mean exploring the same subtree again.
+//
+// Boards are identified by their Zobrist hash: the XOR of a random 64-bit key
+// for every (cell, value) pair that is filled in. Filling in or clearing a cell
+// updates the hash with a single XOR, so the search keeps it up to date as it
+// goes rather than rehashing whole boards. Two different boards sharing a hash
+// is possible but vanishingly unlikely (around n^2 / 2^65 for n stored boards).
+//
+// The table is split into buckets of two slots. The first slot keeps whichever
+// entry took the most search nodes to compute, and the second always takes the
+// newest entry, so expensive results survive while recent ones still get
+// cached. Not thread-safe.
+class TranspositionTable {
+   public:
+	// `height` x `width` boards with values up to `maxValue`. The table holds
+	// at most `capacity` entries, rounded down to a power of two (minimum 2).
+	TranspositionTable(int height, int width, int maxValue, size_t capacity);
+
+	// The Zobrist key for `value` in the cell at (`r`, `c`).
+	uint64_t cellKey(int r, int c, int value) const {
+		return keys[(r * width + c) * (maxValue + 1) + value];
+	}
+
+	// Hashes a whole board from scratch.
+	uint64_t hashBoard(const Board& cellValues) const;
+
+	// Looks up the number of solutions below a board. Returns false if the
+	// board isn't in the table. A count of 0 means the board is a dead end.
+	// Counts the lookup as a hit or miss in `stats`, if supplied.
+	bool probe(uint64_t hash, long long* solutions, SolverStats* stats) const;
+
+	// Records that the board with `hash` has exactly `solutions` solutions,
+	// which took `nodes` search nodes to find out.
+	void store(uint64_t hash, long long solutions, long long nodes,
+			   SolverStats* stats);
+
+	// Forgets everything.
+	void clear();
+
+	size_t capacity() const { return entries.size(); }
+
+	// At most how many bytes the entries of a table holding `capacity`
+	// entries take.
+	static size_t bytesFor(size_t capacity) { return capacity * sizeof(Entry); }
+
+   private:
+	struct Entry {
+		uint64_t hash;
+		long long solutions;
+		long long nodes;
+		bool used;
+	};
+
+	const int height, width, maxValue;
+	std::vector<uint64_t> keys;
+	// Two consecutive entries per bucket.
+	std::vector<Entry> entries;
+	size_t bucketMask;
+};
+
+#endif /* transposition_table_h */